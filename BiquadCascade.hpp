@@ -0,0 +1,187 @@
+#ifndef BiquadCascade_hpp
+#define BiquadCascade_hpp
+
+#include "FilterDesigner.hpp"
+#include "ChannelGroups.hpp"
+
+namespace CascadeHelpers
+{
+	template <typename SampleType>
+	struct Broadcast
+	{
+		static SampleType from (double value) noexcept { return (SampleType) value; }
+	};
+
+	template <typename ElementType>
+	struct Broadcast<juce::dsp::SIMDRegister<ElementType>>
+	{
+		static juce::dsp::SIMDRegister<ElementType> from (double value) noexcept
+		{
+			return juce::dsp::SIMDRegister<ElementType>::expand ((ElementType) value);
+		}
+	};
+
+	template <typename SampleType>
+	inline SampleType broadcast (double value) noexcept { return Broadcast<SampleType>::from (value); }
+
+	inline void snapToZero (float& value) noexcept { juce::dsp::util::snapToZero (value); }
+	inline void snapToZero (double& value) noexcept { juce::dsp::util::snapToZero (value); }
+
+	// SIMD lanes rely on the ScopedNoDenormals in processBlock instead
+	template <typename ElementType>
+	inline void snapToZero (juce::dsp::SIMDRegister<ElementType>&) noexcept {}
+}
+
+//==============================================================================
+// A chain of NumStages biquads in transposed direct form II, the same topology
+// as juce::dsp::IIR::Filter. The stage count is a template parameter, so the
+// per-sample loop over the stages is unrolled and the state stays in registers.
+// SampleType is float, double, or a SIMDRegister of either holding one
+// channel per lane.
+
+template <int NumStages, typename SampleType = float>
+class BiquadCascade
+{
+public:
+	static_assert (NumStages > 0 && NumStages <= CascadeCoefficients::maxStages, "Unsupported stage count");
+
+	void setCoefficients (const CascadeCoefficients& newCoefficients) noexcept
+	{
+		jassert (newCoefficients.numStages == NumStages);
+
+		for (size_t i = 0; i < NumStages; ++i)
+			for (size_t j = 0; j < 5; ++j)
+				coefficients[i][j] = CascadeHelpers::broadcast<SampleType> (newCoefficients.stages[i][j]);
+	}
+
+	void reset() noexcept
+	{
+		state = {};
+	}
+
+	void process (SampleType* data, int numSamples) noexcept
+	{
+		auto s = state;
+
+		for (int n = 0; n < numSamples; ++n)
+		{
+			auto x = data[n];
+
+			for (size_t i = 0; i < NumStages; ++i)
+			{
+				auto& c = coefficients[i];
+				auto y = x * c[0] + s[i][0];
+				s[i][0] = x * c[1] - y * c[3] + s[i][1];
+				s[i][1] = x * c[2] - y * c[4];
+				x = y;
+			}
+
+			data[n] = x;
+		}
+
+		for (auto& stage : s)
+			for (auto& v : stage)
+				CascadeHelpers::snapToZero (v);
+
+		state = s;
+	}
+
+private:
+	std::array<std::array<SampleType, 5>, NumStages> coefficients {};
+	std::array<std::array<SampleType, 2>, NumStages> state {};
+};
+
+//==============================================================================
+// One cascade per slope setting. The slope is resolved once per block, so
+// 12, 24, 36 and 48 dB/oct each run their own fully unrolled instantiation.
+
+template <typename SampleType = float>
+class LowPassCascade
+{
+public:
+	void setCoefficients (const CascadeCoefficients& newCoefficients) noexcept
+	{
+		if (newCoefficients.numStages != numStages)
+		{
+			numStages = newCoefficients.numStages;
+			forSlope ([] (auto& cascade) { cascade.reset(); });
+		}
+
+		forSlope ([&] (auto& cascade) { cascade.setCoefficients (newCoefficients); });
+	}
+
+	void reset() noexcept
+	{
+		forSlope ([] (auto& cascade) { cascade.reset(); });
+	}
+
+	void process (SampleType* data, int numSamples) noexcept
+	{
+		forSlope ([=] (auto& cascade) { cascade.process (data, numSamples); });
+	}
+
+private:
+	template <typename Callback>
+	void forSlope (Callback&& callback) noexcept
+	{
+		switch (numStages)
+		{
+			case 1:	callback (std::get<0> (cascades)); break;
+			case 2:	callback (std::get<1> (cascades)); break;
+			case 3:	callback (std::get<2> (cascades)); break;
+			case 4:	callback (std::get<3> (cascades)); break;
+			default: break;
+		}
+	}
+
+	std::tuple<BiquadCascade<1, SampleType>, BiquadCascade<2, SampleType>,
+			   BiquadCascade<3, SampleType>, BiquadCascade<4, SampleType>> cascades;
+	int numStages = 0;
+};
+
+//==============================================================================
+// Linked multichannel low-pass. Every channel shares the same coefficients, so
+// channels are interleaved into the lanes of a SIMDRegister and filtered in a
+// single pass: L and R share one register, and wider layouts use one register
+// per group of lanes.
+
+template <typename SampleType>
+class LinkedLowPass
+{
+public:
+	using Vector = typename ChannelGroups<SampleType>::Vector;
+
+	void prepare (int maxChannels, int maxBlockSize)
+	{
+		groups.resize ((size_t) ChannelGroups<SampleType>::getNumGroups (maxChannels));
+		channels.prepare (maxBlockSize);
+
+		reset();
+	}
+
+	void setCoefficients (const CascadeCoefficients& newCoefficients) noexcept
+	{
+		for (auto& group : groups)
+			group.setCoefficients (newCoefficients);
+	}
+
+	void reset() noexcept
+	{
+		for (auto& group : groups)
+			group.reset();
+	}
+
+	void process (juce::dsp::AudioBlock<SampleType>& block) noexcept
+	{
+		channels.process (block, (int) groups.size(), [this] (int group, Vector* data, int, int numSamples)
+		{
+			groups[(size_t) group].process (data, numSamples);
+		});
+	}
+
+private:
+	std::vector<LowPassCascade<Vector>> groups;
+	ChannelGroups<SampleType> channels;
+};
+
+#endif // BiquadCascade.hpp
@@ -0,0 +1,93 @@
+#ifndef ButterworthTable_hpp
+#define ButterworthTable_hpp
+
+#include "FilterDesigner.hpp"
+
+//==============================================================================
+// State variable filter coefficients for every Butterworth order the LowPass
+// Slope offers, precomputed on a log-frequency grid. It is built once per
+// sample rate in prepare, after which lookup() is a clamp, one multiply and a
+// linear interpolation, with no trig calls on the audio thread.
+
+class ButterworthTable
+{
+public:
+	static constexpr int maxStages = CascadeCoefficients::maxStages;
+	static constexpr int pointsPerOctave = 32;
+	static constexpr float minFrequency = 10.f;
+
+	struct Coefficients
+	{
+		float g = 0.f;							// tan (pi * fc / fs)
+		std::array<float, maxStages> h {};		// 1 / (1 + R g + g^2) per section
+	};
+
+	// Damping R = 2 cos(theta) of section 'stage' of an order 2N Butterworth
+	static float getDamping (int numStages, int stage) noexcept
+	{
+		return 2.f * std::cos (juce::MathConstants<float>::pi * (float) (2 * stage + 1) / (float) (4 * numStages));
+	}
+
+	void build (double sampleRate)
+	{
+		if (sampleRate == builtSampleRate)
+			return;
+
+		builtSampleRate = sampleRate;
+		minOctave = std::log2 (minFrequency);
+
+		auto maxOctave = (float) std::log2 (0.49 * sampleRate);
+		numPoints = (int) std::ceil ((maxOctave - minOctave) * (float) pointsPerOctave) + 1;
+
+		for (int order = 0; order < maxStages; ++order)
+		{
+			auto numStages = order + 1;
+			auto& table = tables[(size_t) order];
+			table.resize ((size_t) numPoints);
+
+			for (int point = 0; point < numPoints; ++point)
+			{
+				auto octave = juce::jmin (maxOctave, minOctave + (float) point / (float) pointsPerOctave);
+				auto cutoff = std::exp2 ((double) octave);
+				auto g = (float) std::tan (juce::MathConstants<double>::pi * cutoff / sampleRate);
+
+				auto& entry = table[(size_t) point];
+				entry.g = g;
+
+				for (int stage = 0; stage < numStages; ++stage)
+					entry.h[(size_t) stage] = 1.f / (1.f + getDamping (numStages, stage) * g + g * g);
+			}
+		}
+	}
+
+	// Coefficients for a cutoff given in octaves, i.e. log2 (Hz)
+	Coefficients lookup (int numStages, float octave) const noexcept
+	{
+		jassert (numPoints > 1 && numStages > 0 && numStages <= maxStages);
+
+		auto& table = tables[(size_t) (numStages - 1)];
+
+		auto position = juce::jlimit (0.f, (float) (numPoints - 1), (octave - minOctave) * (float) pointsPerOctave);
+		auto index = juce::jmin ((int) position, numPoints - 2);
+		auto frac = position - (float) index;
+
+		auto& a = table[(size_t) index];
+		auto& b = table[(size_t) index + 1];
+
+		Coefficients result;
+		result.g = a.g + frac * (b.g - a.g);
+
+		for (size_t stage = 0; stage < (size_t) numStages; ++stage)
+			result.h[stage] = a.h[stage] + frac * (b.h[stage] - a.h[stage]);
+
+		return result;
+	}
+
+private:
+	std::array<std::vector<Coefficients>, maxStages> tables;
+	double builtSampleRate = 0.0;
+	float minOctave = 0.f;
+	int numPoints = 0;
+};
+
+#endif // ButterworthTable.hpp
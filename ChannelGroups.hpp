@@ -0,0 +1,87 @@
+#ifndef ChannelGroups_hpp
+#define ChannelGroups_hpp
+
+//==============================================================================
+// Interleaves a block's channels into the lanes of SIMDRegisters, one register
+// per group of lanes channels, so a filter whose channels share coefficients
+// runs a whole group in one pass. Any channel count works: with four float
+// lanes, mono and stereo take one group and 7.1.4 three. The spare lanes of
+// the last group are zero-filled and discarded.
+
+template <typename SampleType>
+class ChannelGroups
+{
+public:
+	using Vector = juce::dsp::SIMDRegister<SampleType>;
+
+	static constexpr int lanes = (int) Vector::size();
+
+	static int getNumGroups (int numChannels) noexcept
+	{
+		return (juce::jmax (1, numChannels) + lanes - 1) / lanes;
+	}
+
+	// Must be called while the audio thread is stopped, e.g. from prepareToPlay
+	void prepare (int maxBlockSize)
+	{
+		scratchSize = juce::jmax (1, maxBlockSize);
+		scratch.allocate ((size_t) scratchSize, true);
+	}
+
+	// Calls callback (group, Vector* data, int startSample, int numSamples) for
+	// every group in the block, a scratch-sized piece at a time, and writes the
+	// processed lanes back to their channels.
+	template <typename Callback>
+	void process (juce::dsp::AudioBlock<SampleType>& block, int maxGroups, Callback&& callback) noexcept
+	{
+		auto numChannels = (int) block.getNumChannels();
+		auto numSamples = (int) block.getNumSamples();
+
+		jassert (numChannels <= maxGroups * lanes);
+		jassert (scratchSize > 0); // prepare() hasn't been called
+
+		for (int group = 0; group * lanes < numChannels && group < maxGroups; ++group)
+		{
+			auto firstChannel = group * lanes;
+			auto numInGroup = juce::jmin (lanes, numChannels - firstChannel);
+
+			for (int start = 0; start < numSamples; start += scratchSize)
+			{
+				auto num = juce::jmin (scratchSize, numSamples - start);
+				auto* interleaved = reinterpret_cast<SampleType*> (scratch.get());
+
+				for (int lane = 0; lane < lanes; ++lane)
+				{
+					if (lane < numInGroup)
+					{
+						auto* src = block.getChannelPointer ((size_t) (firstChannel + lane)) + start;
+
+						for (int n = 0; n < num; ++n)
+							interleaved[n * lanes + lane] = src[n];
+					}
+					else
+					{
+						for (int n = 0; n < num; ++n)
+							interleaved[n * lanes + lane] = SampleType (0);
+					}
+				}
+
+				callback (group, scratch.get(), start, num);
+
+				for (int lane = 0; lane < numInGroup; ++lane)
+				{
+					auto* dst = block.getChannelPointer ((size_t) (firstChannel + lane)) + start;
+
+					for (int n = 0; n < num; ++n)
+						dst[n] = interleaved[n * lanes + lane];
+				}
+			}
+		}
+	}
+
+private:
+	juce::HeapBlock<Vector> scratch;
+	int scratchSize = 0;
+};
+
+#endif // ChannelGroups.hpp
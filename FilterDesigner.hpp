@@ -0,0 +1,194 @@
+#ifndef FilterDesigner_hpp
+#define FilterDesigner_hpp
+
+#include "TripleBuffer.hpp"
+
+//==============================================================================
+// Normalised biquad coefficients (b0, b1, b2, a1, a2) for every stage of a
+// Butterworth low-pass cascade. Plain data, so it can be handed between
+// threads without touching the heap. Designed in double so the 64-bit path
+// keeps its precision at low cutoffs; the float path rounds them on use.
+
+struct CascadeCoefficients
+{
+	static constexpr int maxStages = 4;
+
+	int numStages = 0;
+	std::array<std::array<double, 5>, maxStages> stages {};
+};
+
+//==============================================================================
+// One background thread shared by every plugin instance in the process.
+
+class FilterDesignThread : public juce::TimeSliceThread
+{
+public:
+	FilterDesignThread() : juce::TimeSliceThread ("LowPass Designer")
+	{
+		startThread (juce::Thread::Priority::low);
+	}
+
+	~FilterDesignThread() override
+	{
+		stopThread (1000);
+	}
+};
+
+//==============================================================================
+// Designs the low-pass cascade off the audio thread. The audio thread calls
+// request() (wait-free) when the cutoff or slope changes, and picks up the
+// finished coefficients with pull(). Filter design and its allocations only
+// ever happen on the shared FilterDesignThread or in prepare().
+//
+// A request for the cutoff and slope that were last designed or requested is
+// dropped, so asking again for the filter already running never swaps in
+// coefficients at whichever block the thread happens to finish on.
+//
+// The thread polls each designer every pollIntervalMs while requests keep
+// coming, and backs off to maxIdleIntervalMs once they stop, so a session of
+// idle instances barely wakes it. The first design after a pause can take that
+// long to arrive; the previous coefficients keep running meanwhile.
+
+class LowPassDesigner : private juce::TimeSliceClient
+{
+public:
+	LowPassDesigner() = default;
+
+	~LowPassDesigner() override
+	{
+		designThread->removeTimeSliceClient (this);
+	}
+
+	// Must be called while the audio thread is stopped, e.g. from prepareToPlay
+	const CascadeCoefficients& prepare (double newSampleRate, float freq, int slope)
+	{
+		designThread->removeTimeSliceClient (this);
+
+		sampleRate = newSampleRate;
+		lastHandledRequest = requestCount.load();
+		idleIntervalMs = pollIntervalMs;
+		results.pull(); // drop anything designed for the old sample rate
+
+		design (sampleRate, freq, slope, current);
+		lastFreq = freq;
+		lastSlope = slope;
+
+		designThread->addTimeSliceClient (this);
+		return current;
+	}
+
+	// Audio thread
+	void request (float freq, int slope) noexcept
+	{
+		if (freq == lastFreq && slope == lastSlope)
+			return;
+
+		lastFreq = freq;
+		lastSlope = slope;
+
+		requestedFreq.store (freq, std::memory_order_relaxed);
+		requestedSlope.store (slope, std::memory_order_relaxed);
+		requestCount.fetch_add (1, std::memory_order_release);
+	}
+
+	// Audio thread
+	bool pull() noexcept
+	{
+		if (! results.pull())
+			return false;
+
+		auto& result = results.getReadBuffer();
+
+		if (result.request < firstAcceptedRequest)
+			return false;
+
+		current = result.coefficients;
+		return true;
+	}
+
+	// Audio thread. Takes coefficients designed elsewhere, e.g. with a program,
+	// and discards any design requested before this call.
+	void setCoefficients (const CascadeCoefficients& newCoefficients) noexcept
+	{
+		current = newCoefficients;
+		firstAcceptedRequest = requestCount.load (std::memory_order_relaxed) + 1;
+
+		// Designed for a cutoff this class doesn't know, so any request differs
+		lastFreq = -1.f;
+	}
+
+	const CascadeCoefficients& getCoefficients() const noexcept { return current; }
+
+	static void design (double sampleRate, float freq, int slope, CascadeCoefficients& dest)
+	{
+		freq = juce::jlimit (10.f, (float) (sampleRate * 0.49), freq);
+
+		auto coefficients = juce::dsp::FilterDesign<double>::designIIRLowpassHighOrderButterworthMethod (freq, sampleRate, 2 * (slope + 1));
+
+		dest.numStages = juce::jmin (coefficients.size(), CascadeCoefficients::maxStages);
+
+		for (int i = 0; i < dest.numStages; ++i)
+		{
+			auto& raw = coefficients[i]->coefficients;
+			jassert (raw.size() == 5);
+			std::copy (raw.begin(), raw.begin() + 5, dest.stages[(size_t) i].begin());
+		}
+	}
+
+private:
+	struct Result
+	{
+		CascadeCoefficients coefficients;
+		juce::uint32 request = 0;
+	};
+
+	int useTimeSlice() override
+	{
+		auto count = requestCount.load (std::memory_order_acquire);
+
+		if (count == lastHandledRequest)
+		{
+			idleIntervalMs = juce::jmin (maxIdleIntervalMs, idleIntervalMs * 2);
+			return idleIntervalMs;
+		}
+
+		lastHandledRequest = count;
+
+		auto& result = results.getWriteBuffer();
+		result.request = count;
+		design (sampleRate,
+				requestedFreq.load (std::memory_order_relaxed),
+				requestedSlope.load (std::memory_order_relaxed),
+				result.coefficients);
+		results.publish();
+
+		// A moving cutoff usually sends more, so keep up with it
+		idleIntervalMs = pollIntervalMs;
+		return pollIntervalMs;
+	}
+
+	static constexpr int pollIntervalMs = 2;
+	static constexpr int maxIdleIntervalMs = 50;
+
+	juce::SharedResourcePointer<FilterDesignThread> designThread;
+
+	double sampleRate = 44100.0;
+
+	std::atomic<float> requestedFreq { 20000.f };
+	std::atomic<int> requestedSlope { 0 };
+	std::atomic<juce::uint32> requestCount { 0 };
+	juce::uint32 lastHandledRequest = 0;
+	juce::uint32 firstAcceptedRequest = 0;
+	int idleIntervalMs = pollIntervalMs;	// design thread, apart from prepare()
+
+	// Audio thread, apart from prepare()
+	float lastFreq = -1.f;
+	int lastSlope = -1;
+
+	TripleBuffer<Result> results;
+	CascadeCoefficients current;
+
+	JUCE_DECLARE_NON_COPYABLE (LowPassDesigner)
+};
+
+#endif // FilterDesigner.hpp
@@ -0,0 +1,361 @@
+#ifndef Lfo_hpp
+#define Lfo_hpp
+
+inline juce::StringArray OscWaveformNames =
+{
+	"Sine",
+	"Square",
+	"Triangle",
+	"Sawtooth",
+};
+
+enum OscWaveforms
+{
+	SINE,
+	SQUARE,
+	TRIANGLE,
+	SAWTOOTH
+};
+
+//==============================================================================
+// Waveform kernels. Each one maps a phase in [-pi, pi) to [-1, 1] and gives the
+// same shape as the lambdas the juce::dsp::Oscillator used to be initialised with.
+
+namespace LfoKernels
+{
+	template <int Wave>
+	struct Kernel;
+
+	template <>
+	struct Kernel<SINE>
+	{
+		// Fold into [-pi/2, pi/2] and use an odd 9th order polynomial,
+		// within 4e-6 of std::sin over the whole cycle.
+		static inline float eval (float x) noexcept
+		{
+			constexpr float pi = juce::MathConstants<float>::pi;
+			constexpr float halfPi = juce::MathConstants<float>::halfPi;
+
+			x = x > halfPi ? pi - x : (x < -halfPi ? -pi - x : x);
+
+			const float x2 = x * x;
+			return x * (1.f + x2 * (-1.f / 6.f + x2 * (1.f / 120.f + x2 * (-1.f / 5040.f + x2 * (1.f / 362880.f)))));
+		}
+	};
+
+	template <>
+	struct Kernel<SQUARE>
+	{
+		static inline float eval (float x) noexcept { return x < 0.f ? -1.f : 1.f; }
+	};
+
+	template <>
+	struct Kernel<TRIANGLE>
+	{
+		static inline float eval (float x) noexcept { return (std::abs (2.f * x) / juce::MathConstants<float>::pi) - 1.f; }
+	};
+
+	template <>
+	struct Kernel<SAWTOOTH>
+	{
+		static inline float eval (float x) noexcept { return x / juce::MathConstants<float>::pi; }
+	};
+
+	//==============================================================================
+	// The same shapes for a SIMDRegister of phases, also in [-pi, pi)
+
+	using Vector = juce::dsp::SIMDRegister<float>;
+
+	template <int Wave>
+	struct VectorKernel;
+
+	template <>
+	struct VectorKernel<SINE>
+	{
+		static inline Vector eval (Vector x) noexcept
+		{
+			constexpr float pi = juce::MathConstants<float>::pi;
+
+			const auto fold = Vector::max (Vector::min (x, Vector::expand (pi) - x), Vector::expand (-pi) - x);
+			const auto x2 = fold * fold;
+
+			auto poly = Vector::expand (1.f / 362880.f);
+			poly = Vector::expand (-1.f / 5040.f) + x2 * poly;
+			poly = Vector::expand (1.f / 120.f) + x2 * poly;
+			poly = Vector::expand (-1.f / 6.f) + x2 * poly;
+			poly = Vector::expand (1.f) + x2 * poly;
+
+			return fold * poly;
+		}
+	};
+
+	template <>
+	struct VectorKernel<SQUARE>
+	{
+		static inline Vector eval (Vector x) noexcept
+		{
+			const auto positive = Vector::expand (2.f) & Vector::greaterThanOrEqual (x, Vector::expand (0.f));
+			return positive - Vector::expand (1.f);
+		}
+	};
+
+	template <>
+	struct VectorKernel<TRIANGLE>
+	{
+		static inline Vector eval (Vector x) noexcept
+		{
+			const auto magnitude = Vector::max (x, Vector::expand (0.f) - x);
+			return magnitude * Vector::expand (2.f / juce::MathConstants<float>::pi) - Vector::expand (1.f);
+		}
+	};
+
+	template <>
+	struct VectorKernel<SAWTOOTH>
+	{
+		static inline Vector eval (Vector x) noexcept { return x * Vector::expand (1.f / juce::MathConstants<float>::pi); }
+	};
+}
+
+//==============================================================================
+// Phase accumulator LFO. The waveform is picked once per call by a switch and
+// the sample loop runs a fully inlined kernel, so there is no std::function or
+// per-sample dispatch.
+
+class LfoEngine
+{
+public:
+	void prepare (double newSampleRate) noexcept
+	{
+		sampleRate = newSampleRate;
+		updateIncrement();
+	}
+
+	void reset() noexcept
+	{
+		phase = 0.f;
+		anchored = false;
+	}
+
+	// Phase in radians, [0, 2pi) being one full cycle
+	void setPhase (float newPhase) noexcept
+	{
+		phase = newPhase >= 0.f && newPhase < twoPi ? newPhase : 0.f;
+	}
+
+	// Ties the phase to a position given in cycles, e.g. the host's song
+	// position: until releaseAnchor(), the n-th sample rendered after this call
+	// sits at cycles + n * cyclesPerSample, worked out in double for every
+	// sample rather than accumulated, so it doesn't depend on how the calls
+	// are split. Only the calls without per-sample frequencies follow it.
+	void setAnchor (double cycles, double newCyclesPerSample) noexcept
+	{
+		anchorCycles = cycles - std::floor (cycles);
+		cyclesPerSample = newCyclesPerSample;
+		samplesSinceAnchor = 0;
+		anchored = true;
+		phase = anchoredPhase (0);
+	}
+
+	// Goes back to accumulating from the last anchored phase
+	void releaseAnchor() noexcept
+	{
+		anchored = false;
+	}
+
+	void setFrequency (float newFrequency) noexcept
+	{
+		frequency = newFrequency;
+		updateIncrement();
+	}
+
+	float getFrequency() const noexcept { return frequency; }
+
+	void setWaveform (int newWave) noexcept
+	{
+		wave = newWave;
+	}
+
+	int getWaveform() const noexcept { return wave; }
+
+	float processSample() noexcept
+	{
+		switch (wave)
+		{
+			default:
+			case SINE:		return tick<SINE>();
+			case SQUARE:	return tick<SQUARE>();
+			case TRIANGLE:	return tick<TRIANGLE>();
+			case SAWTOOTH:	return tick<SAWTOOTH>();
+		}
+	}
+
+	// The waveform is computed in float and stored at the destination's precision
+	template <typename SampleType>
+	void renderBlock (SampleType* dest, int numSamples) noexcept
+	{
+		if (anchored)
+		{
+			switch (wave)
+			{
+				default:
+				case SINE:		renderAnchored<SINE> (dest, numSamples); break;
+				case SQUARE:	renderAnchored<SQUARE> (dest, numSamples); break;
+				case TRIANGLE:	renderAnchored<TRIANGLE> (dest, numSamples); break;
+				case SAWTOOTH:	renderAnchored<SAWTOOTH> (dest, numSamples); break;
+			}
+
+			return;
+		}
+
+		switch (wave)
+		{
+			default:
+			case SINE:		render<SINE> (dest, numSamples); break;
+			case SQUARE:	render<SQUARE> (dest, numSamples); break;
+			case TRIANGLE:	render<TRIANGLE> (dest, numSamples); break;
+			case SAWTOOTH:	render<SAWTOOTH> (dest, numSamples); break;
+		}
+	}
+
+	// As above, with the frequency given per sample, e.g. by a BlockRamp.
+	// The last frequency is kept for the following blocks.
+	void renderBlock (float* dest, int numSamples, const float* frequencies) noexcept
+	{
+		if (numSamples <= 0)
+			return;
+
+		switch (wave)
+		{
+			default:
+			case SINE:		render<SINE> (dest, numSamples, frequencies); break;
+			case SQUARE:	render<SQUARE> (dest, numSamples, frequencies); break;
+			case TRIANGLE:	render<TRIANGLE> (dest, numSamples, frequencies); break;
+			case SAWTOOTH:	render<SAWTOOTH> (dest, numSamples, frequencies); break;
+		}
+
+		setFrequency (frequencies[numSamples - 1]);
+	}
+
+	// Writes the phase each sample would be evaluated at, in [0, 2pi), and
+	// advances exactly as renderBlock() would, for callers that evaluate the
+	// waveform themselves, e.g. at several phase offsets. frequencies may be
+	// nullptr to keep the current one.
+	void renderPhases (float* dest, int numSamples, const float* frequencies = nullptr) noexcept
+	{
+		if (numSamples <= 0)
+			return;
+
+		auto p = phase;
+
+		if (frequencies != nullptr)
+		{
+			const auto radiansPerHz = (float) (twoPi / sampleRate);
+
+			for (int i = 0; i < numSamples; ++i)
+			{
+				dest[i] = p;
+				p = wrap (p + frequencies[i] * radiansPerHz);
+			}
+
+			setFrequency (frequencies[numSamples - 1]);
+		}
+		else if (anchored)
+		{
+			for (int i = 0; i < numSamples; ++i)
+				dest[i] = anchoredPhase (samplesSinceAnchor + i);
+
+			samplesSinceAnchor += numSamples;
+			p = anchoredPhase (samplesSinceAnchor);
+		}
+		else
+		{
+			for (int i = 0; i < numSamples; ++i)
+			{
+				dest[i] = p;
+				p = wrap (p + increment);
+			}
+		}
+
+		phase = p;
+	}
+
+private:
+	static constexpr float pi = juce::MathConstants<float>::pi;
+	static constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+	template <int Wave>
+	inline float tick() noexcept
+	{
+		const float out = LfoKernels::Kernel<Wave>::eval (phase - pi);
+		phase = wrap (phase + increment);
+		return out;
+	}
+
+	template <int Wave, typename SampleType>
+	void render (SampleType* dest, int numSamples) noexcept
+	{
+		auto p = phase;
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			dest[i] = (SampleType) LfoKernels::Kernel<Wave>::eval (p - pi);
+			p = wrap (p + increment);
+		}
+
+		phase = p;
+	}
+
+	template <int Wave, typename SampleType>
+	void renderAnchored (SampleType* dest, int numSamples) noexcept
+	{
+		for (int i = 0; i < numSamples; ++i)
+			dest[i] = (SampleType) LfoKernels::Kernel<Wave>::eval (anchoredPhase (samplesSinceAnchor + i) - pi);
+
+		samplesSinceAnchor += numSamples;
+		phase = anchoredPhase (samplesSinceAnchor);
+	}
+
+	template <int Wave>
+	void render (float* dest, int numSamples, const float* frequencies) noexcept
+	{
+		const auto radiansPerHz = (float) (twoPi / sampleRate);
+		auto p = phase;
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			dest[i] = LfoKernels::Kernel<Wave>::eval (p - pi);
+			p = wrap (p + frequencies[i] * radiansPerHz);
+		}
+
+		phase = p;
+	}
+
+	inline float anchoredPhase (juce::int64 sample) const noexcept
+	{
+		const auto cycles = anchorCycles + (double) sample * cyclesPerSample;
+		const auto p = (float) (juce::MathConstants<double>::twoPi * (cycles - std::floor (cycles)));
+		return p < twoPi ? p : 0.f;
+	}
+
+	static inline float wrap (float p) noexcept
+	{
+		return p >= twoPi ? p - twoPi : p;
+	}
+
+	void updateIncrement() noexcept
+	{
+		increment = (float) (twoPi * frequency / sampleRate);
+	}
+
+	double sampleRate = 44100.0;
+	float frequency = 1.f;
+	float increment = 0.f;
+	float phase = 0.f;
+	double anchorCycles = 0.0;
+	double cyclesPerSample = 0.0;
+	juce::int64 samplesSinceAnchor = 0;
+	bool anchored = false;
+	int wave = SINE;
+};
+
+#endif // Lfo.hpp
@@ -0,0 +1,159 @@
+#ifndef LfoBank_hpp
+#define LfoBank_hpp
+
+#include "Lfo.hpp"
+
+//==============================================================================
+// Up to maxLfos LFOs stored structure-of-arrays: phases, increments and shape
+// weights sit in contiguous arrays, and each SIMD register advances
+// Vector::size() LFOs per instruction. Lanes may use different shapes; every
+// shape used within a group is evaluated and each lane keeps its own by a 0/1
+// weight, so there are no per-lane branches. render() writes one buffer per
+// LFO, which destinations read directly.
+
+class LfoBank
+{
+public:
+	using Vector = LfoKernels::Vector;
+
+	static constexpr int maxLfos = 8;
+	static constexpr int numShapes = 4;
+
+	static_assert (maxLfos % Vector::size() == 0, "The bank must fill whole registers");
+
+	LfoBank()
+	{
+		frequencies.fill (1.f);
+
+		for (int i = 0; i < maxLfos; ++i)
+			setWaveform (i, SINE);
+	}
+
+	void prepare (double newSampleRate, int maxBlockSize)
+	{
+		sampleRate = newSampleRate;
+		outputs.setSize (maxLfos, juce::jmax (1, maxBlockSize));
+		outputs.clear();
+
+		for (int i = 0; i < maxLfos; ++i)
+			updateIncrement (i);
+	}
+
+	void reset() noexcept
+	{
+		phases.fill (0.f);
+	}
+
+	void setNumLfos (int newNumLfos) noexcept
+	{
+		numLfos = juce::jlimit (0, maxLfos, newNumLfos);
+	}
+
+	int getNumLfos() const noexcept { return numLfos; }
+
+	// Phase in radians, [0, 2pi) being one full cycle
+	void setPhase (int index, float newPhase) noexcept
+	{
+		phases[(size_t) index] = newPhase >= 0.f && newPhase < twoPi ? newPhase : 0.f;
+	}
+
+	void setFrequency (int index, float newFrequency) noexcept
+	{
+		frequencies[(size_t) index] = newFrequency;
+		updateIncrement (index);
+	}
+
+	float getFrequency (int index) const noexcept { return frequencies[(size_t) index]; }
+
+	void setWaveform (int index, int newWave) noexcept
+	{
+		for (int shape = 0; shape < numShapes; ++shape)
+			weights[(size_t) shape][(size_t) index] = shape == newWave ? 1.f : 0.f;
+	}
+
+	// Renders the next numSamples of every active LFO into its output buffer
+	void render (int numSamples) noexcept
+	{
+		jassert (numSamples <= outputs.getNumSamples());
+		numSamples = juce::jmin (numSamples, outputs.getNumSamples());
+
+		for (size_t first = 0; first < (size_t) numLfos; first += Vector::size())
+			renderGroup (first, numSamples);
+	}
+
+	const float* getOutput (int index) const noexcept
+	{
+		jassert (index < numLfos);
+		return outputs.getReadPointer (index);
+	}
+
+private:
+	static constexpr float pi = juce::MathConstants<float>::pi;
+	static constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+	void renderGroup (size_t first, int numSamples) noexcept
+	{
+		constexpr auto width = Vector::size();
+
+		bool usesShape[numShapes] {};
+
+		for (size_t shape = 0; shape < (size_t) numShapes; ++shape)
+			for (size_t lane = 0; lane < width; ++lane)
+				usesShape[shape] = usesShape[shape] || weights[shape][first + lane] != 0.f;
+
+		const auto sineWeight = Vector::fromRawArray (weights[SINE].data() + first);
+		const auto squareWeight = Vector::fromRawArray (weights[SQUARE].data() + first);
+		const auto triangleWeight = Vector::fromRawArray (weights[TRIANGLE].data() + first);
+		const auto sawtoothWeight = Vector::fromRawArray (weights[SAWTOOTH].data() + first);
+		const auto increment = Vector::fromRawArray (increments.data() + first);
+		const auto twoPiVector = Vector::expand (twoPi);
+
+		auto phase = Vector::fromRawArray (phases.data() + first);
+
+		float* dest[width] {};
+		auto numLanes = juce::jmin (width, (size_t) numLfos - first);
+
+		for (size_t lane = 0; lane < numLanes; ++lane)
+			dest[lane] = outputs.getWritePointer ((int) (first + lane));
+
+		alignas (32) float values[width];
+
+		for (int i = 0; i < numSamples; ++i)
+		{
+			const auto x = phase - Vector::expand (pi);
+			auto out = Vector::expand (0.f);
+
+			if (usesShape[SINE])		out += sineWeight * LfoKernels::VectorKernel<SINE>::eval (x);
+			if (usesShape[SQUARE])		out += squareWeight * LfoKernels::VectorKernel<SQUARE>::eval (x);
+			if (usesShape[TRIANGLE])	out += triangleWeight * LfoKernels::VectorKernel<TRIANGLE>::eval (x);
+			if (usesShape[SAWTOOTH])	out += sawtoothWeight * LfoKernels::VectorKernel<SAWTOOTH>::eval (x);
+
+			out.copyToRawArray (values);
+
+			for (size_t lane = 0; lane < numLanes; ++lane)
+				dest[lane][i] = values[lane];
+
+			phase = phase + increment;
+			phase = phase - (twoPiVector & Vector::greaterThanOrEqual (phase, twoPiVector));
+		}
+
+		phase.copyToRawArray (phases.data() + first);
+	}
+
+	void updateIncrement (int index) noexcept
+	{
+		increments[(size_t) index] = (float) (twoPi * frequencies[(size_t) index] / sampleRate);
+	}
+
+	double sampleRate = 44100.0;
+	int numLfos = 0;
+
+	alignas (32) std::array<float, maxLfos> phases {};
+	alignas (32) std::array<float, maxLfos> increments {};
+	std::array<float, maxLfos> frequencies {};
+	alignas (32) std::array<std::array<float, maxLfos>, numShapes> weights {};
+
+	juce::AudioBuffer<float> outputs;
+};
+
+#endif // LfoBank.hpp
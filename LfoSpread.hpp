@@ -0,0 +1,101 @@
+#ifndef LfoSpread_hpp
+#define LfoSpread_hpp
+
+#include "Lfo.hpp"
+
+//==============================================================================
+// One LFO evaluated at a different phase on every channel. The phases come
+// from a single accumulator (see LfoEngine::renderPhases), so the channels
+// can't drift apart; channel c runs c * offset ahead of channel 0, which at
+// 180 degrees on stereo is a classic auto-pan. Each channel is evaluated by
+// the vector kernels Vector::size() samples at a time, with the waveform
+// picked once per render.
+
+class LfoSpread
+{
+public:
+	using Vector = LfoKernels::Vector;
+
+	// Must be called while the audio thread is stopped, e.g. from prepareToPlay
+	void prepare (int newMaxChannels, int maxBlockSize)
+	{
+		maxChannels = juce::jmax (1, newMaxChannels);
+		stride = (juce::jmax (1, maxBlockSize) + (int) Vector::size() - 1) / (int) Vector::size();
+
+		// Whole registers per channel, so the last one can be evaluated in full
+		phases.assign ((size_t) stride, Vector::expand (0.f));
+		outputs.assign ((size_t) (maxChannels * stride), Vector::expand (0.f));
+	}
+
+	// Offset between neighbouring channels in radians; 0 puts every channel in phase
+	void setOffset (float newOffset) noexcept		{ offset = newOffset; }
+	bool isActive() const noexcept					{ return offset != 0.f; }
+
+	void setWaveform (int newWave) noexcept			{ wave = newWave; }
+
+	// Room for one block of phases, to be filled before render()
+	float* getPhaseBuffer() noexcept { return reinterpret_cast<float*> (phases.data()); }
+
+	void render (int numChannels, int numSamples) noexcept
+	{
+		jassert (numChannels <= maxChannels && numSamples <= stride * (int) Vector::size());
+		numChannels = juce::jmin (numChannels, maxChannels);
+
+		auto numVectors = juce::jmin (stride, (numSamples + (int) Vector::size() - 1) / (int) Vector::size());
+
+		switch (wave)
+		{
+			default:
+			case SINE:		render<SINE> (numChannels, numVectors); break;
+			case SQUARE:	render<SQUARE> (numChannels, numVectors); break;
+			case TRIANGLE:	render<TRIANGLE> (numChannels, numVectors); break;
+			case SAWTOOTH:	render<SAWTOOTH> (numChannels, numVectors); break;
+		}
+	}
+
+	// The waveform on one channel for the last render(); channel 0 has no offset
+	const float* getOutput (int channel) const noexcept
+	{
+		jassert (channel < maxChannels);
+		return reinterpret_cast<const float*> (outputs.data() + channel * stride);
+	}
+
+private:
+	static constexpr float pi = juce::MathConstants<float>::pi;
+	static constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+	template <int Wave>
+	void render (int numChannels, int numVectors) noexcept
+	{
+		const auto twoPiVector = Vector::expand (twoPi);
+
+		for (int ch = 0; ch < numChannels; ++ch)
+		{
+			// Phases are in [0, 2pi), so one conditional subtract wraps them
+			auto channelOffset = std::fmod ((float) ch * offset, twoPi);
+
+			if (channelOffset < 0.f)
+				channelOffset += twoPi;
+
+			const auto shift = Vector::expand (channelOffset - pi);
+			const auto wrapAt = Vector::expand (pi);
+			auto* dest = outputs.data() + ch * stride;
+
+			for (int i = 0; i < numVectors; ++i)
+			{
+				auto x = phases[(size_t) i] + shift;
+				x = x - (twoPiVector & Vector::greaterThanOrEqual (x, wrapAt));
+				dest[i] = LfoKernels::VectorKernel<Wave>::eval (x);
+			}
+		}
+	}
+
+	std::vector<Vector> phases, outputs;
+	int maxChannels = 0;
+	int stride = 0;		// registers per channel
+
+	float offset = 0.f;
+	int wave = SINE;
+};
+
+#endif // LfoSpread.hpp
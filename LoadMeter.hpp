@@ -0,0 +1,171 @@
+#ifndef LoadMeter_hpp
+#define LoadMeter_hpp
+
+// Define as 0 to compile the timing out of processBlock altogether
+#ifndef OSC_LOAD_METER
+ #define OSC_LOAD_METER 1
+#endif
+
+//==============================================================================
+// Per-instance DSP load, in the manner of juce::AudioProcessLoadMeasurer. Each
+// block's processing time goes into a histogram with binsPerOctave log-spaced
+// bins, which costs two tick reads, a log2 and a few adds per block. Once
+// windowSeconds of audio have been processed, the window's p50, p99 and max
+// block times and its average and peak fraction of the real-time budget are
+// published through atomics, and the histogram starts again.
+//
+// Percentiles are reported at the centre of their bin, so within about 4%.
+
+class LoadMeter
+{
+public:
+	static constexpr double windowSeconds = 1.0;
+
+	struct Stats
+	{
+		float p50Us = 0.f;
+		float p99Us = 0.f;
+		float maxUs = 0.f;
+		float averageLoad = 0.f;	// processing time / audio time
+		float peakLoad = 0.f;		// the same for the slowest block
+		juce::uint32 window = 0;	// incremented with every publish, 0 until the first
+	};
+
+	// Must be called while the audio thread is stopped, e.g. from prepareToPlay
+	void prepare (double newSampleRate) noexcept
+	{
+		sampleRate = newSampleRate;
+		secondsPerTick = 1.0 / (double) juce::Time::getHighResolutionTicksPerSecond();
+		startWindow();
+	}
+
+	//==============================================================================
+	// Audio thread. Times the enclosing scope as one block of numSamples.
+	class ScopedBlock
+	{
+	public:
+		ScopedBlock (LoadMeter& meterToUse, int numSamplesToUse) noexcept
+		   #if OSC_LOAD_METER
+			: meter (meterToUse), numSamples (numSamplesToUse), start (juce::Time::getHighResolutionTicks())
+		   #endif
+		{
+			juce::ignoreUnused (meterToUse, numSamplesToUse);
+		}
+
+		~ScopedBlock() noexcept
+		{
+		   #if OSC_LOAD_METER
+			meter.addBlock (numSamples, juce::Time::getHighResolutionTicks() - start);
+		   #endif
+		}
+
+	private:
+	   #if OSC_LOAD_METER
+		LoadMeter& meter;
+		int numSamples;
+		juce::int64 start;
+	   #endif
+
+		JUCE_DECLARE_NON_COPYABLE (ScopedBlock)
+	};
+
+	//==============================================================================
+	// Any thread. The fields are read one by one, so a reader racing a publish
+	// may mix two neighbouring windows.
+	Stats getStats() const noexcept
+	{
+		Stats stats;
+		stats.window = published.window.load (std::memory_order_acquire);
+		stats.p50Us = published.p50Us.load (std::memory_order_relaxed);
+		stats.p99Us = published.p99Us.load (std::memory_order_relaxed);
+		stats.maxUs = published.maxUs.load (std::memory_order_relaxed);
+		stats.averageLoad = published.averageLoad.load (std::memory_order_relaxed);
+		stats.peakLoad = published.peakLoad.load (std::memory_order_relaxed);
+		return stats;
+	}
+
+private:
+	static constexpr int binsPerOctave = 8;
+	static constexpr int numBins = 20 * binsPerOctave;
+	static constexpr double minUs = 0.25; // bin 0 holds everything up to here; the last bin everything past ~260 ms
+
+	void addBlock (int numSamples, juce::int64 ticks) noexcept
+	{
+		if (numSamples <= 0 || sampleRate <= 0.0)
+			return;
+
+		auto seconds = (double) ticks * secondsPerTick;
+		auto us = seconds * 1.0e6;
+		auto audioSeconds = numSamples / sampleRate;
+
+		auto bin = us > minUs ? (int) (std::log2 (us / minUs) * binsPerOctave) : 0;
+		++histogram[(size_t) juce::jmin (bin, numBins - 1)];
+		++numBlocks;
+
+		maxUs = juce::jmax (maxUs, us);
+		peakLoad = juce::jmax (peakLoad, seconds / audioSeconds);
+		busySeconds += seconds;
+		windowAudioSeconds += audioSeconds;
+
+		if (windowAudioSeconds >= windowSeconds)
+		{
+			publish();
+			startWindow();
+		}
+	}
+
+	double percentile (double fraction) const noexcept
+	{
+		auto target = juce::jmax ((juce::int64) 1, (juce::int64) std::ceil (fraction * (double) numBlocks));
+		juce::int64 count = 0;
+
+		for (int bin = 0; bin < numBins; ++bin)
+		{
+			count += histogram[(size_t) bin];
+
+			if (count >= target)
+				return minUs * std::exp2 ((bin + 0.5) / binsPerOctave);
+		}
+
+		return maxUs;
+	}
+
+	void publish() noexcept
+	{
+		// A bin's centre can overshoot the slowest block it holds
+		published.p50Us.store ((float) juce::jmin (maxUs, percentile (0.50)), std::memory_order_relaxed);
+		published.p99Us.store ((float) juce::jmin (maxUs, percentile (0.99)), std::memory_order_relaxed);
+		published.maxUs.store ((float) maxUs, std::memory_order_relaxed);
+		published.averageLoad.store ((float) (busySeconds / windowAudioSeconds), std::memory_order_relaxed);
+		published.peakLoad.store ((float) peakLoad, std::memory_order_relaxed);
+		published.window.fetch_add (1, std::memory_order_release);
+	}
+
+	void startWindow() noexcept
+	{
+		histogram.fill (0);
+		numBlocks = 0;
+		maxUs = 0.0;
+		peakLoad = 0.0;
+		busySeconds = 0.0;
+		windowAudioSeconds = 0.0;
+	}
+
+	double sampleRate = 0.0;
+	double secondsPerTick = 0.0;
+
+	// Audio thread only
+	std::array<juce::int64, numBins> histogram {};
+	juce::int64 numBlocks = 0;
+	double maxUs = 0.0, peakLoad = 0.0;
+	double busySeconds = 0.0, windowAudioSeconds = 0.0;
+
+	struct
+	{
+		std::atomic<float> p50Us { 0.f }, p99Us { 0.f }, maxUs { 0.f };
+		std::atomic<float> averageLoad { 0.f }, peakLoad { 0.f };
+		std::atomic<juce::uint32> window { 0 };
+	} published;
+};
+
+#endif // LoadMeter.hpp
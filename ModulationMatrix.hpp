@@ -0,0 +1,232 @@
+#ifndef ModulationMatrix_hpp
+#define ModulationMatrix_hpp
+
+#include "ParameterRamp.hpp"
+
+enum ModSource
+{
+	ModSource_Lfo1,
+	ModSource_Lfo2,
+	ModSource_Lfo3,
+	NumModSources
+};
+
+enum ModDestination
+{
+	ModDest_Volume,
+	ModDest_Cutoff,
+	ModDest_Gain,
+	ModDest_Phase,
+	NumModDestinations
+};
+
+inline juce::StringArray ModSourceNames =
+{
+	"LFO 1",
+	"LFO 2",
+	"LFO 3",
+};
+
+inline juce::StringArray ModDestinationNames =
+{
+	"Volume",
+	"Cutoff",
+	"Gain",
+	"Phase",
+};
+
+//==============================================================================
+// Routes every source to every destination with its own depth. Whenever a depth
+// changes, updateRoutes() compiles the routes that are non-zero or still
+// ramping into a flat, preallocated list, so process() loops over active routes
+// only and a destination nobody routes to costs nothing.
+//
+// Volume sums depth * lfo, as the tremolo always has. The other destinations
+// sum depth * (1 + lfo) / 2, which stays within [0, depth] and so only ever
+// pulls the cutoff, gain or phase away from its setting in one direction.
+
+class ModulationMatrix
+{
+public:
+	static constexpr int numCells = NumModSources * NumModDestinations;
+	static constexpr double rampSeconds = 0.02;
+
+	static bool isUnipolar (int destination) noexcept { return destination != ModDest_Volume; }
+
+	void prepare (double sampleRate, int maxBlockSize)
+	{
+		for (auto& depth : depths)
+			depth.prepare (sampleRate, rampSeconds, maxBlockSize);
+
+		outputs.setSize (NumModDestinations, juce::jmax (1, maxBlockSize));
+		outputs.clear();
+		dirty = true;
+	}
+
+	// Jumps every depth to its target, e.g. after prepareToPlay
+	void reset() noexcept
+	{
+		for (auto& depth : depths)
+			depth.setCurrentAndTargetValue (depth.getTargetValue());
+
+		dirty = true;
+	}
+
+	void setDepth (int source, int destination, float newDepth) noexcept
+	{
+		auto& depth = depths[(size_t) getCell (source, destination)];
+
+		if (newDepth != depth.getTargetValue())
+		{
+			depth.setTargetValue (newDepth);
+			dirty = true;
+		}
+	}
+
+	// Recompiles the route list if any depth changed. Call before asking which
+	// sources are used, then render those and call process().
+	void updateRoutes() noexcept
+	{
+		if (dirty)
+			compile();
+	}
+
+	bool usesSource (int source) const noexcept				{ return sourceUsed[(size_t) source]; }
+	bool isActive (int destination) const noexcept			{ return destinationActive[(size_t) destination]; }
+
+	// sources holds one buffer of numSamples per ModSource; unused ones may be nullptr
+	void process (const float* const* sources, int numSamples) noexcept
+	{
+		jassert (numSamples <= outputs.getNumSamples());
+		numSamples = juce::jmin (numSamples, outputs.getNumSamples());
+
+		for (int destination = 0; destination < NumModDestinations; ++destination)
+			if (destinationActive[(size_t) destination])
+				juce::FloatVectorOperations::clear (outputs.getWritePointer (destination), numSamples);
+
+		std::copy (sources, sources + NumModSources, lastSources.begin());
+
+		for (int i = 0; i < numRoutes; ++i)
+		{
+			auto& route = routes[(size_t) i];
+
+			route.ramp = route.depth->advance (numSamples);
+			accumulate (route, sources[route.source], outputs.getWritePointer (route.destination), numSamples);
+
+			// A route that has faded out drops from the list next block
+			if (route.ramp != nullptr && ! route.depth->isSmoothing())
+				dirty = true;
+		}
+	}
+
+	bool isRouted (int source, int destination) const noexcept
+	{
+		for (int i = 0; i < numRoutes; ++i)
+			if (routes[(size_t) i].source == source && routes[(size_t) i].destination == destination)
+				return true;
+
+		return false;
+	}
+
+	// Sums one destination again with the sources and depths of the last
+	// process() call, but with replacement standing in for source, e.g. the
+	// same LFO at another phase. dest must hold numSamples.
+	void renderWithSource (int destination, int source, const float* replacement, float* dest, int numSamples) const noexcept
+	{
+		juce::FloatVectorOperations::clear (dest, numSamples);
+
+		for (int i = 0; i < numRoutes; ++i)
+		{
+			auto& route = routes[(size_t) i];
+
+			if (route.destination == destination)
+				accumulate (route, route.source == source ? replacement : lastSources[(size_t) route.source], dest, numSamples);
+		}
+	}
+
+	// Summed modulation for the last process() call, or nullptr if nothing is routed there
+	float* getOutput (int destination) noexcept
+	{
+		return destinationActive[(size_t) destination] ? outputs.getWritePointer (destination) : nullptr;
+	}
+
+private:
+	struct Route
+	{
+		BlockRamp* depth = nullptr;
+		int source = 0;
+		int destination = 0;
+		bool unipolar = false;
+		const float* ramp = nullptr;	// the depth's last block while it ramps
+	};
+
+	static void accumulate (const Route& route, const float* src, float* dest, int numSamples) noexcept
+	{
+		if (auto* ramp = route.ramp)
+		{
+			if (route.unipolar)
+				for (int n = 0; n < numSamples; ++n)
+					dest[n] += ramp[n] * (0.5f + 0.5f * src[n]);
+			else
+				for (int n = 0; n < numSamples; ++n)
+					dest[n] += ramp[n] * src[n];
+		}
+		else
+		{
+			auto depth = route.depth->getCurrentValue();
+
+			if (route.unipolar)
+			{
+				juce::FloatVectorOperations::addWithMultiply (dest, src, 0.5f * depth, numSamples);
+				juce::FloatVectorOperations::add (dest, 0.5f * depth, numSamples);
+			}
+			else
+			{
+				juce::FloatVectorOperations::addWithMultiply (dest, src, depth, numSamples);
+			}
+		}
+	}
+
+	static int getCell (int source, int destination) noexcept
+	{
+		jassert (source >= 0 && source < NumModSources && destination >= 0 && destination < NumModDestinations);
+		return source * NumModDestinations + destination;
+	}
+
+	void compile() noexcept
+	{
+		numRoutes = 0;
+		sourceUsed.fill (false);
+		destinationActive.fill (false);
+
+		for (int destination = 0; destination < NumModDestinations; ++destination)
+		{
+			for (int source = 0; source < NumModSources; ++source)
+			{
+				auto& depth = depths[(size_t) getCell (source, destination)];
+
+				if (depth.getTargetValue() == 0.f && ! depth.isSmoothing())
+					continue;
+
+				routes[(size_t) numRoutes++] = { &depth, source, destination, isUnipolar (destination), nullptr };
+				sourceUsed[(size_t) source] = true;
+				destinationActive[(size_t) destination] = true;
+			}
+		}
+
+		dirty = false;
+	}
+
+	std::array<BlockRamp, numCells> depths;
+	std::array<Route, numCells> routes;
+	int numRoutes = 0;
+
+	std::array<bool, NumModSources> sourceUsed {};
+	std::array<bool, NumModDestinations> destinationActive {};
+	bool dirty = true;
+
+	juce::AudioBuffer<float> outputs;
+	std::array<const float*, NumModSources> lastSources {};
+};
+
+#endif // ModulationMatrix.hpp
@@ -2,22 +2,7 @@
 #define Oscillator_hpp
 
 #include "ProcessorBase.hpp"
-
-juce::StringArray OscWaveformNames =
-{
-	"Sine",
-	"Square",
-	"Triangle",
-	"Sawtooth",
-};
-
-enum OscWaveforms
-{
-	SINE,
-	SQUARE,
-	TRIANGLE,
-	SAWTOOTH
-};
+#include "Lfo.hpp"
 
 enum modTimeIndex
 {
@@ -37,7 +22,11 @@ enum modAdjIndex
 	Triplet = 2,
 };
 
-class OscillatorProcessor  : public ProcessorBase
+// The LFO source. It always runs in float and renders into the processor's
+// control buffers; SampleType only picks the ProcessorBase it implements.
+
+template <typename SampleType = float>
+class OscillatorProcessor  : public ProcessorBase<SampleType>
 {
 public:
      const juce::String getName() const override { return "Oscillator"; }
@@ -45,33 +34,17 @@ public:
     OscillatorProcessor() {
       oscillator.setFrequency (440.0f);
 
-      oscillator.initialise ([] (float x) { return std::sin (x); });
+      oscillator.setWaveform (SINE);
 
 	  lfo.setFrequency(lfoFrequency);
 
-	  lfo.initialise([](float x) { return std::sin(x); });
+	  lfo.setWaveform(SINE);
 
     }
 
 	void setWaveForm(int wave)
 	{
-		switch (wave) {
-			default:
-			case SINE:
-				oscillator.initialise ([] (float x) { return std::sin (x); });	
-				break;
-			case SQUARE:	
-				oscillator.initialise ([] (float x) { return x < 0.f ? -1.f : 1.f; });	
-				break;
-			case TRIANGLE:
-				oscillator.initialise ([] (float x) { return (abs(2*x) / juce::MathConstants<float>::pi) - 1.f; });	
-				break;
-			case SAWTOOTH:
-				oscillator.initialise ([] (float x) { return (x / juce::MathConstants<float>::pi); });	
-				break;
-
-
-		}
+		oscillator.setWaveform(wave);
 	}
 	
 	// TODO: implement
@@ -80,15 +53,10 @@ public:
 		;
 	}
 	
-	bool update(juce::AudioProcessorValueTreeState&) override
-	{
-		return false;
-	}
-	
 	void prepare (const juce::dsp::ProcessSpec& spec) override
 	{
-		oscillator.prepare (spec);
-		lfo.prepare(spec);
+		oscillator.prepare (spec.sampleRate);
+		lfo.prepare(spec.sampleRate);
 	}
     
 	void setFrequency(float frequency)
@@ -97,21 +65,24 @@ public:
 
 	}
 	
-	void process (juce::dsp::ProcessContextReplacing<float>& context) override 
+	float processSample () 
 	{
+		return oscillator.processSample();
+	}
 
-		float lfoSample = lfo.processSample(0.0f);
+	void renderBlock(float* dest, int numSamples)
+	{
+		oscillator.renderBlock(dest, numSamples);
+	}
 
-		// Modulate the main oscillator frequency
-		float modulatedFrequency = 440.0f + (lfoSample * modulationDepth);
-		oscillator.setFrequency(modulatedFrequency);
+	void renderBlock(float* dest, int numSamples, const float* frequencies)
+	{
+		oscillator.renderBlock(dest, numSamples, frequencies);
+	}
 
-        oscillator.process (context);
-    }
-	
-	float processSample () 
+	void renderPhases(float* dest, int numSamples, const float* frequencies = nullptr)
 	{
-		return oscillator.processSample(0.f);
+		oscillator.renderPhases(dest, numSamples, frequencies);
 	}
 
     void reset() override {
@@ -140,49 +111,69 @@ public:
 
 
 	
-	float setModulator(/*int func, int wave,*/ int noteVal, int adj, bool sync)
-	 {
-		float timing;
+	// Length of one LFO cycle in beats for a note value and feel
+	static double getBeatsPerCycle(int noteVal, int adj)
+	{
+		double timing;
 		switch (adj)
 		{
 			default:
 
 			case Straight: 
-				timing = 1.f; break;
+				timing = 1.; break;
 
 			case Dotted: 
-				timing = 1.5f; break;
+				timing = 1.5; break;
 
 			case Triplet: 
-				timing = 0.33333333f; break;
+				timing = 0.33333333; break;
 		}
 
-		float mpc; //MILISECONDS PER CYCLE
-		//		if (sync) {
 		switch (noteVal) {
 			default:
 
 			case Double: 
-				mpc = (60000.f / bpm) * 16 * timing; break;
+				return 16 * timing;
 
 			case Whole: 
-				mpc = (60000.f / bpm) * 8 * timing; break;
+				return 8 * timing;
 
 			case Half: 
-				mpc = (60000.f / bpm) * 4 * timing; break;
+				return 4 * timing;
 
 			case Quarter: 
-				mpc = (60000.f / bpm) * 2 * timing; break;
+				return 2 * timing;
 
 			case Eighth: 
-				mpc = (60000.f / bpm) * timing; break;
+				return timing;
 
 			case Sixteenth:
-				mpc = (60000.f / bpm) * 0.5f * timing; break;
+				return 0.5 * timing;
 
 			case ThirtySecond: 
-				mpc = (60000.f / bpm) * 0.25f * timing; break;
+				return 0.25 * timing;
 		}
+	}
+
+	// Aligns the LFO to the host's song position, so that a cycle starts on
+	// every multiple of getBeatsPerCycle() quarter notes. The phase of each
+	// following sample is taken from ppqPosition plus the beats elapsed at
+	// this tempo until releaseSync().
+	void syncToPpq(double ppqPosition, double tempo, double sampleRate, int noteVal, int adj)
+	{
+		auto beatsPerCycle = getBeatsPerCycle(noteVal, adj);
+		oscillator.setAnchor(ppqPosition / beatsPerCycle, tempo / (60.0 * sampleRate * beatsPerCycle));
+	}
+
+	void releaseSync()
+	{
+		oscillator.releaseAnchor();
+	}
+
+	float setModulator(/*int func, int wave,*/ int noteVal, int adj, bool sync)
+	 {
+		//		if (sync) {
+		float mpc = (60000.f / bpm) * (float) getBeatsPerCycle(noteVal, adj); //MILISECONDS PER CYCLE
 		return 1. / (mpc * 0.001f); // return a frequency
 		//		}
 		//		else { // TODO: free floating 
@@ -202,13 +193,13 @@ public:
 	
 
 private:
-    juce::dsp::Oscillator<float> oscillator;
+    LfoEngine oscillator;
 
 	float bpm = 120.0;
 
 	float lowPassFreq;
 
-	juce::dsp::Oscillator<float> lfo; // LFO for modulation
+	LfoEngine lfo; // LFO for modulation
 
 	float lfoFrequency = 1.0f; // Default LFO frequency in Hz
 
@@ -0,0 +1,147 @@
+#ifndef ParameterRamp_hpp
+#define ParameterRamp_hpp
+
+//==============================================================================
+// Block-rate parameter smoothing. Instead of a per-sample getNextValue() with a
+// branch on every sample, advance() writes the whole ramp for a block into a
+// preallocated buffer that the vectorised gain and filter stages read directly.
+// While the value is static advance() returns nullptr and costs one branch per
+// block, and callers use getCurrentValue() instead.
+//
+// Linear ramps step by a fixed amount per sample; multiplicative ramps by a
+// fixed ratio, which suits frequencies.
+
+class BlockRamp
+{
+public:
+	enum class Type
+	{
+		linear,
+		multiplicative
+	};
+
+	explicit BlockRamp (Type rampType = Type::linear) : type (rampType) {}
+
+	void prepare (double sampleRate, double rampLengthSeconds, int maxBlockSize)
+	{
+		rampLength = juce::jmax (1, juce::roundToInt (sampleRate * rampLengthSeconds));
+		buffer.resize ((size_t) juce::jmax (1, maxBlockSize));
+		setCurrentAndTargetValue (target);
+	}
+
+	void setCurrentAndTargetValue (float newValue) noexcept
+	{
+		current = target = newValue;
+		countdown = 0;
+	}
+
+	void setTargetValue (float newValue) noexcept
+	{
+		if (newValue == target)
+			return;
+
+		target = newValue;
+
+		if (type == Type::multiplicative && (current <= 0.f || target <= 0.f))
+		{
+			jassertfalse; // multiplicative ramps need positive values
+			setCurrentAndTargetValue (newValue);
+			return;
+		}
+
+		countdown = rampLength;
+		step = type == Type::linear ? (target - current) / (float) rampLength
+									: std::pow (target / current, 1.f / (float) rampLength);
+	}
+
+	float getCurrentValue() const noexcept	{ return current; }
+	float getTargetValue() const noexcept	{ return target; }
+	bool isSmoothing() const noexcept		{ return countdown > 0; }
+
+	// Per-sample values for the next numSamples, or nullptr if the value is static
+	const float* advance (int numSamples) noexcept
+	{
+		if (countdown == 0)
+			return nullptr;
+
+		jassert (numSamples <= (int) buffer.size());
+		numSamples = juce::jmin (numSamples, (int) buffer.size());
+
+		auto* dest = buffer.data();
+		auto numRamp = juce::jmin (countdown, numSamples);
+
+		if (type == Type::linear)
+			fillLinear (dest, numRamp);
+		else
+			fillMultiplicative (dest, numRamp);
+
+		countdown -= numRamp;
+		current = countdown == 0 ? target : dest[numRamp - 1];
+
+		if (numRamp < numSamples)
+			juce::FloatVectorOperations::fill (dest + numRamp, target, numSamples - numRamp);
+
+		return dest;
+	}
+
+	// Moves the ramp on without producing values, for blocks that don't use it
+	void skip (int numSamples) noexcept
+	{
+		if (countdown == 0)
+			return;
+
+		auto numRamp = juce::jmin (countdown, numSamples);
+		countdown -= numRamp;
+
+		if (countdown == 0)
+			current = target;
+		else if (type == Type::linear)
+			current += step * (float) numRamp;
+		else
+			current *= std::pow (step, (float) numRamp);
+	}
+
+private:
+	// No loop-carried dependency, so this vectorises
+	void fillLinear (float* dest, int num) const noexcept
+	{
+		for (int i = 0; i < num; ++i)
+			dest[i] = current + step * (float) (i + 1);
+	}
+
+	// Four interleaved geometric sequences, each advanced by step^4, so the
+	// inner loop is one four-wide multiply
+	void fillMultiplicative (float* dest, int num) const noexcept
+	{
+		float lanes[4];
+		auto value = current;
+
+		for (auto& lane : lanes)
+			lane = (value *= step);
+
+		auto step4 = step * step * step * step;
+		int i = 0;
+
+		for (; i + 4 <= num; i += 4)
+		{
+			for (int lane = 0; lane < 4; ++lane)
+			{
+				dest[i + lane] = lanes[lane];
+				lanes[lane] *= step4;
+			}
+		}
+
+		for (int lane = 0; i < num; ++i, ++lane)
+			dest[i] = lanes[lane];
+	}
+
+	Type type;
+	int rampLength = 1;
+	int countdown = 0;
+	float current = 0.f;
+	float target = 0.f;
+	float step = 0.f;
+	std::vector<float> buffer;
+};
+
+#endif // ParameterRamp.hpp
@@ -9,17 +9,136 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+//==============================================================================
+ScopeComponent::ScopeComponent (const juce::String& labelToUse, float minToUse, float maxToUse, bool showRangeToUse, juce::Colour colourToUse)
+    : label (labelToUse), minValue (minToUse), maxValue (maxToUse), showRange (showRangeToUse), colour (colourToUse)
+{
+    setOpaque (true);
+}
+
+void ScopeComponent::push (float low, float high) noexcept
+{
+    lows[(size_t) writeIndex] = low;
+    highs[(size_t) writeIndex] = high;
+    writeIndex = (writeIndex + 1) % historySize;
+}
+
+float ScopeComponent::toY (float value) const noexcept
+{
+    auto proportion = (juce::jlimit (minValue, maxValue, value) - minValue) / (maxValue - minValue);
+    return (float) getHeight() * (1.0f - proportion);
+}
+
+void ScopeComponent::resized()
+{
+    drawBackground();
+}
+
+void ScopeComponent::drawBackground()
+{
+    if (getWidth() <= 0 || getHeight() <= 0)
+    {
+        background = {};
+        return;
+    }
+
+    background = juce::Image (juce::Image::RGB, getWidth(), getHeight(), false);
+    juce::Graphics g (background);
+
+    g.fillAll (juce::Colours::black);
+
+    g.setColour (juce::Colours::white.withAlpha (0.1f));
+
+    for (int i = 1; i < 4; ++i)
+        g.drawHorizontalLine (juce::roundToInt (getHeight() * i / 4.0f), 0.0f, (float) getWidth());
+
+    for (int i = 1; i < 8; ++i)
+        g.drawVerticalLine (juce::roundToInt (getWidth() * i / 8.0f), 0.0f, (float) getHeight());
+
+    if (minValue < 0.0f && maxValue > 0.0f)
+    {
+        g.setColour (juce::Colours::white.withAlpha (0.3f));
+        g.drawHorizontalLine (juce::roundToInt (toY (0.0f)), 0.0f, (float) getWidth());
+    }
+
+    g.setColour (juce::Colours::white.withAlpha (0.7f));
+    g.setFont (juce::FontOptions (13.0f));
+    g.drawText (label, getLocalBounds().reduced (6, 4), juce::Justification::topLeft, false);
+}
+
+void ScopeComponent::paint (juce::Graphics& g)
+{
+    if (background.isValid())
+        g.drawImageAt (background, 0, 0);
+    else
+        g.fillAll (juce::Colours::black);
+
+    auto width = getWidth();
+
+    if (width <= 0)
+        return;
+
+    g.setColour (colour);
+
+    // One history entry per pixel column, oldest on the left
+    auto indexAt = [&] (int x)
+    {
+        auto age = (historySize - 1) - (int) ((juce::int64) x * (historySize - 1) / juce::jmax (1, width - 1));
+        return (size_t) ((writeIndex - 1 - age + 2 * historySize) % historySize);
+    };
+
+    if (showRange)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            auto index = indexAt (x);
+            auto top = toY (highs[index]);
+            auto bottom = toY (lows[index]);
+            g.drawVerticalLine (x, top, juce::jmax (top + 1.0f, bottom));
+        }
+    }
+    else
+    {
+        juce::Path trace;
+        trace.preallocateSpace (3 * width);
+        trace.startNewSubPath (0.0f, toY (highs[indexAt (0)]));
+
+        for (int x = 1; x < width; ++x)
+            trace.lineTo ((float) x, toY (highs[indexAt (x)]));
+
+        g.strokePath (trace, juce::PathStrokeType (1.5f));
+    }
+}
+
 //==============================================================================
 BasicOscillatorAudioProcessorEditor::BasicOscillatorAudioProcessorEditor (BasicOscillatorAudioProcessor& p)
     : AudioProcessorEditor (&p), audioProcessor (p)
 {
+    addAndMakeVisible (parameters);
+    addAndMakeVisible (lfoScope);
+    addAndMakeVisible (modulationScope);
+    addAndMakeVisible (outputScope);
+
+    loadLabel.setFont (juce::FontOptions (13.0f));
+    loadLabel.setText ("DSP load: waiting for audio", juce::dontSendNotification);
+    addAndMakeVisible (loadLabel);
+
+    // Frames left over from a previous editor would show up as a jump in time
+    auto& telemetry = audioProcessor.getTelemetry();
+    telemetry.discardAll();
+    telemetry.setEnabled (true);
+
+    startTimerHz (frameRateHz);
+
     // Make sure that before the constructor has finished, you've set the
     // editor's size to whatever you need it to be.
-    setSize (400, 300);
+    setSize (parameters.getWidth() + 420, juce::jmax (parameters.getHeight(), 360));
 }
 
 BasicOscillatorAudioProcessorEditor::~BasicOscillatorAudioProcessorEditor()
 {
+    stopTimer();
+    audioProcessor.getTelemetry().setEnabled (false);
 }
 
 //==============================================================================
@@ -27,14 +146,63 @@ void BasicOscillatorAudioProcessorEditor::paint (juce::Graphics& g)
 {
     // (Our component is opaque, so we must completely fill the background with a solid colour)
     g.fillAll (getLookAndFeel().findColour (juce::ResizableWindow::backgroundColourId));
-
-    g.setColour (juce::Colours::white);
-    g.setFont (juce::FontOptions (15.0f));
-    g.drawFittedText ("Hello World!", getLocalBounds(), juce::Justification::centred, 1);
 }
 
 void BasicOscillatorAudioProcessorEditor::resized()
 {
-    // This is generally where you'll want to lay out the positions of any
-    // subcomponents in your editor..
+    auto bounds = getLocalBounds();
+
+    parameters.setBounds (bounds.removeFromLeft (parameters.getWidth()));
+
+    auto scopes = bounds.reduced (8);
+    loadLabel.setBounds (scopes.removeFromBottom (20));
+    auto scopeHeight = scopes.getHeight() / 3;
+
+    lfoScope.setBounds (scopes.removeFromTop (scopeHeight).reduced (0, 4));
+    modulationScope.setBounds (scopes.removeFromTop (scopeHeight).reduced (0, 4));
+    outputScope.setBounds (scopes.reduced (0, 4));
+}
+
+void BasicOscillatorAudioProcessorEditor::timerCallback()
+{
+    auto& telemetry = audioProcessor.getTelemetry();
+
+    updateLoadLabel();
+
+    Telemetry::Frame frame;
+    bool received = false;
+
+    while (telemetry.pop (frame))
+    {
+        lfoScope.push (frame.lfo, frame.lfo);
+        modulationScope.push (frame.modulation, frame.modulation);
+        outputScope.push (frame.outputMin, frame.outputMax);
+        received = true;
+    }
+
+    // Nothing moves while the host is stopped, so there's nothing to redraw
+    if (received)
+    {
+        lfoScope.repaint();
+        modulationScope.repaint();
+        outputScope.repaint();
+    }
+}
+
+void BasicOscillatorAudioProcessorEditor::updateLoadLabel()
+{
+    auto stats = audioProcessor.getLoadStats();
+
+    // Published about once a second, so most frames have nothing new
+    if (stats.window == lastLoadWindow)
+        return;
+
+    lastLoadWindow = stats.window;
+
+    loadLabel.setText ("DSP load " + juce::String (stats.averageLoad * 100.0f, 2) + " %"
+                       + "   peak " + juce::String (stats.peakLoad * 100.0f, 1) + " %"
+                       + "   block p50 " + juce::String (stats.p50Us, 1) + " us"
+                       + "   p99 " + juce::String (stats.p99Us, 1) + " us"
+                       + "   max " + juce::String (stats.maxUs, 1) + " us",
+                       juce::dontSendNotification);
 }
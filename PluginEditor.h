@@ -12,9 +12,51 @@
 #include "PluginProcessor.h"
 
 //==============================================================================
-/**
+/** A scrolling trace of the last few seconds of one telemetry signal.
+
+    The grid, zero line and label never change between frames, so they are
+    drawn once into an image whenever the scope is resized, and paint() only
+    blits that image and draws the trace over it. Range scopes draw a min/max
+    column per pixel, the others a line.
+*/
+class ScopeComponent  : public juce::Component
+{
+public:
+    ScopeComponent (const juce::String& label, float minValue, float maxValue, bool showRange, juce::Colour colour);
+
+    void push (float low, float high) noexcept;
+
+    void paint (juce::Graphics&) override;
+    void resized() override;
+
+    // Two seconds at Telemetry::framesPerSecond
+    static constexpr int historySize = 1000;
+
+private:
+    float toY (float value) const noexcept;
+    void drawBackground();
+
+    juce::String label;
+    float minValue, maxValue;
+    bool showRange;
+    juce::Colour colour;
+
+    std::array<float, historySize> lows {}, highs {};
+    int writeIndex = 0;
+
+    juce::Image background;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScopeComponent)
+};
+
+//==============================================================================
+/** The parameters next to live scopes of LFO 1, the summed modulation and the
+    output, with this instance's DSP load underneath. The scopes are fed from
+    the processor's Telemetry, drained by a timer at frameRateHz, and only
+    repainted when new frames have arrived.
 */
-class BasicOscillatorAudioProcessorEditor  : public juce::AudioProcessorEditor
+class BasicOscillatorAudioProcessorEditor  : public juce::AudioProcessorEditor,
+                                             private juce::Timer
 {
 public:
     BasicOscillatorAudioProcessorEditor (BasicOscillatorAudioProcessor&);
@@ -24,10 +66,25 @@ public:
     void paint (juce::Graphics&) override;
     void resized() override;
 
+    static constexpr int frameRateHz = 30;
+
 private:
+    void timerCallback() override;
+
     // This reference is provided as a quick way for your editor to
     // access the processor object that created it.
     BasicOscillatorAudioProcessor& audioProcessor;
 
+    juce::GenericAudioProcessorEditor parameters { audioProcessor };
+
+    ScopeComponent lfoScope        { "LFO 1", -1.0f, 1.0f, false, juce::Colours::orange };
+    ScopeComponent modulationScope { "Modulation", -1.0f, 1.0f, false, juce::Colours::skyblue };
+    ScopeComponent outputScope     { "Output", -1.0f, 1.0f, true, juce::Colours::lightgreen };
+
+    juce::Label loadLabel;
+    juce::uint32 lastLoadWindow = 0;
+
+    void updateLoadLabel();
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BasicOscillatorAudioProcessorEditor)
 };
@@ -10,6 +10,30 @@
 #include "PluginEditor.h"
 #include "Oscillator.hpp"
 
+namespace
+{
+    std::atomic<int> nextInstanceId{ 1 };
+
+    // Every instance's timer runs on the message thread, so instances logging
+    // to the same file can share its stream without their lines overlapping
+    std::shared_ptr<juce::FileOutputStream> openLoadLog(const juce::File& file)
+    {
+        static std::map<juce::String, std::weak_ptr<juce::FileOutputStream>> openLogs;
+
+        auto& entry = openLogs[file.getFullPathName()];
+
+        if (auto stream = entry.lock())
+            return stream;
+
+        std::shared_ptr<juce::FileOutputStream> stream = file.createOutputStream();
+
+        if (stream != nullptr && stream->failedToOpen())
+            stream.reset();
+
+        entry = stream;
+        return stream;
+    }
+}
 
 //==============================================================================
 BasicOscillatorAudioProcessor::BasicOscillatorAudioProcessor()
@@ -23,11 +47,17 @@ BasicOscillatorAudioProcessor::BasicOscillatorAudioProcessor()
                      #endif
                        )
 #endif
+     , instanceId(nextInstanceId++)
 {
+    auto logPath = juce::SystemStats::getEnvironmentVariable("OSC_LOAD_LOG", {});
+
+    if (juce::File::isAbsolutePath(logPath))
+        setLoadLogFile(juce::File(logPath));
 }
 
 BasicOscillatorAudioProcessor::~BasicOscillatorAudioProcessor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -70,22 +100,33 @@ double BasicOscillatorAudioProcessor::getTailLengthSeconds() const
 
 int BasicOscillatorAudioProcessor::getNumPrograms()
 {
-    return 1;   // NB: some hosts don't cope very well if you tell them there are 0 programs,
-                // so this should be at least 1, even if you're not really implementing programs.
+    return ProgramBank::numPrograms;
 }
 
 int BasicOscillatorAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return currentProgram.load();
 }
 
 void BasicOscillatorAudioProcessor::setCurrentProgram (int index)
 {
+    if (! juce::isPositiveAndBelow(index, ProgramBank::numPrograms))
+        return;
+
+    // The audio thread swaps in the prepared DSP state at its next block. Some
+    // hosts call this from the audio thread, in which case the parameters are
+    // updated later by the timer.
+    programBank.request(index);
+
+    if (juce::MessageManager::existsAndIsCurrentThread())
+        setParametersFromProgram(index);
+    else
+        programToPublish.store(index);
 }
 
 const juce::String BasicOscillatorAudioProcessor::getProgramName (int index)
 {
-    return {};
+    return ProgramBank::getProgram(index).name;
 }
 
 void BasicOscillatorAudioProcessor::changeProgramName (int index, const juce::String& newName)
@@ -104,72 +145,58 @@ void BasicOscillatorAudioProcessor::prepareToPlay(double sampleRate, int samples
     spec.numChannels = getTotalNumInputChannels();
 
     myOsc.prepare(spec);
-    leftChain.prepare(spec);
-    rightChain.prepare(spec);
 
-    // myLfo.prepare(spec);
+    forEachPath([&](auto& path) { path.pipeline.prepare(spec); });
+
+    lfoBank.prepare(sampleRate, samplesPerBlock);
+    lfoBank.setNumLfos(numExtraLfos);
+    modMatrix.prepare(sampleRate, samplesPerBlock);
 
     myOsc.reset();
-    //myLfo.reset();
+    lfoBank.reset();
 
-    auto chainSettings = getChainSettings(apvts);
+    modulationBuffer.setSize(1, samplesPerBlock);
+    modulationBuffer.clear();
 
+    lfoSpread.prepare(getTotalNumInputChannels(), samplesPerBlock);
+    channelTremolo.setSize(getTotalNumInputChannels(), samplesPerBlock);
+    channelTremolo.clear();
 
-    auto cutCoefficients = juce::dsp::FilterDesign<float>::designIIRHighpassHighOrderButterworthMethod(chainSettings.highCutFreq, sampleRate, 2 * (chainSettings.highCutSlope + 1));
+    telemetry.prepare(sampleRate, samplesPerBlock);
+    loadMeter.prepare(sampleRate);
 
-    auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-    auto& rightHighCut = leftChain.get<ChainPositions::HighCut>();
+    cutoffRamp.prepare(sampleRate, rampSeconds, samplesPerBlock);
+    rateRamp.prepare(sampleRate, rampSeconds, samplesPerBlock);
 
+    currentBpm = -1.0;
 
-    leftHighCut.setBypassed<0>(true);
-    leftHighCut.setBypassed<1>(true);
+    auto chainSettings = getChainSettings(apvts);
 
-    
-    switch (chainSettings.highCutSlope)
-    {
-    case Slope_12:
-    {
-        *leftHighCut.get<0>().coefficients = *cutCoefficients[0];
-        leftHighCut.setBypassed<0>(false);
-        break;
-    }
-    case Slope_24:
-    {
-        *leftHighCut.get<0>().coefficients = *cutCoefficients[0];
-        leftHighCut.setBypassed<0>(false);
-        *leftHighCut.get<1>().coefficients = *cutCoefficients[1];
-        leftHighCut.setBypassed<1>(false);
-        break;
-    }
-    }
+    cutoffRamp.setCurrentAndTargetValue(std::log2(juce::jmax(1.0f, chainSettings.highCutFreq)));
+    rateRamp.setCurrentAndTargetValue(apvts.getRawParameterValue(ParamID::Rate)->load());
 
-    rightHighCut.setBypassed<0>(true);
-    rightHighCut.setBypassed<1>(true);
+    updateLowPassFilter(lowPassDesigner.prepare(sampleRate, chainSettings.highCutFreq, chainSettings.highCutSlope));
+    setLowPassSlope(chainSettings.highCutSlope);
+    programBank.prepare(sampleRate);
 
-    switch (chainSettings.highCutSlope)
-    {
-    case Slope_12:
-    {
-        *rightHighCut.get<0>().coefficients = *cutCoefficients[0];
-        rightHighCut.setBypassed<0>(false);
-        break;
-    }
-    case Slope_24:
-    {
-        *rightHighCut.get<0>().coefficients = *cutCoefficients[0];
-        rightHighCut.setBypassed<0>(false);
-        *rightHighCut.get<1>().coefficients = *cutCoefficients[1];
-        rightHighCut.setBypassed<1>(false);
-        break;
-    }
-    }
-    
+    // Start the routes at their current depths rather than fading them in
+    params.update();
+    updateModulationRoutes();
+    modMatrix.reset();
+
+    // Force the waveform and rate to be refreshed on the next block
+    params.markAllDirty();
+
+    prepared = true;
+    updateTimer();
 }
 
 void BasicOscillatorAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+    prepared = false;
+    updateTimer();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -179,12 +206,11 @@ bool BasicOscillatorAudioProcessor::isBusesLayoutSupported (const BusesLayout& l
     juce::ignoreUnused (layouts);
     return true;
   #else
-    // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    // Every stage runs on any number of channels, so any layout goes: mono,
+    // stereo, quad, 5.1, 7.1.4, ambisonic beds or discrete stems.
+    auto numChannels = layouts.getMainOutputChannelSet().size();
+
+    if (numChannels == 0 || numChannels > maxChannels)
         return false;
 
     // This checks if the input layout matches the output layout
@@ -199,16 +225,29 @@ bool BasicOscillatorAudioProcessor::isBusesLayoutSupported (const BusesLayout& l
 #endif
 
 void BasicOscillatorAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBlockImpl(buffer, midiMessages);
+}
+
+void BasicOscillatorAudioProcessor::processBlock (juce::AudioBuffer<double>& buffer, juce::MidiBuffer& midiMessages)
+{
+    processBlockImpl(buffer, midiMessages);
+}
+
+template <typename SampleType>
+void BasicOscillatorAudioProcessor::processBlockImpl (juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    LoadMeter::ScopedBlock loadTimer(loadMeter, buffer.getNumSamples());
+
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    juce::dsp::AudioBlock<float> audioBlock(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(audioBlock);
+    auto& path = getPath<SampleType>();
+
+    juce::dsp::AudioBlock<SampleType> audioBlock(buffer);
 
-    auto leftBlock = audioBlock.getSingleChannelBlock(0);
-    auto rightBlock = audioBlock.getSingleChannelBlock(1);
+    auto inputBlock = audioBlock.getSubsetChannelBlock(0, (size_t) totalNumInputChannels);
 
 
     // In case we have more outputs than inputs, this code clears any output
@@ -221,198 +260,475 @@ void BasicOscillatorAudioProcessor::processBlock (juce::AudioBuffer<float>& buff
         buffer.clear (i, 0, buffer.getNumSamples());
     
 
-    auto sync = apvts.getRawParameterValue("InSync")->load();
-    auto noteIndex = static_cast<int>(apvts.getRawParameterValue("NoteVal")->load());
-    auto feelIndex = static_cast<int>(apvts.getRawParameterValue("Feel")->load());
-    auto lowPassCut = apvts.getRawParameterValue("LowPass")->load();
-    auto mod = static_cast<int>(apvts.getRawParameterValue("Modulation")->load());
-    auto depth = apvts.getRawParameterValue("depth")->load();
+    params.update();
+
+    for (const auto metadata : midiMessages)
+    {
+        auto message = metadata.getMessage();
+
+        if (message.isProgramChange() && juce::isPositiveAndBelow(message.getProgramChangeNumber(), ProgramBank::numPrograms))
+        {
+            programBank.request(message.getProgramChangeNumber());
+            programToPublish.store(message.getProgramChangeNumber());
+        }
+    }
 
+    auto program = programBank.pullRequest();
 
-    auto waveIndex = static_cast<int>(apvts.getRawParameterValue("OscShape")->load());
+    if (program >= 0)
+        applyProgram(program);
 
-    myOsc.setWaveForm(setOscillatorWaveform(waveIndex));
+    auto sync = params.inSync;
+    auto mod = params.modulation;
+    auto numSamples = buffer.getNumSamples();
 
-    myOsc.setLowPassFreq(lowPassCut);
+    if (params.waveChanged)
+    {
+        myOsc.setWaveForm(setOscillatorWaveform(params.waveIndex));
+        lfoSpread.setWaveform(setOscillatorWaveform(params.waveIndex));
+    }
 
+    // Coefficients are designed on a background thread and picked up by the LowPass branch
+    if (params.filterChanged)
+    {
+        myOsc.setLowPassFreq(params.lowPassFreq);
+        cutoffRamp.setTargetValue(std::log2(juce::jmax(1.0f, params.lowPassFreq)));
+        requestLowPassDesign();
+        setLowPassSlope(params.lowPassSlope);
+    }
 
-    if (sync == true)
+    if (params.extraLfosChanged)
     {
-        //INSYNC IS ON =================================================================================
-        if (mod == 0) //Volume
+        for (int i = 0; i < numExtraLfos; ++i)
         {
-            double bpm;
-            auto tmp_bpm = getPlayHead()->getPosition()->getBpm();
+            lfoBank.setFrequency(i, params.extraLfoRates[(size_t) i]);
+            lfoBank.setWaveform(i, params.extraLfoShapes[(size_t) i]);
+        }
+    }
 
+    // The LFO rate is only recomputed when its inputs or the host tempo change
+    if (sync == true)
+    {
+        double bpm = 120.0;
+        juce::Optional<double> ppq;
 
-            if (tmp_bpm.hasValue())
-            {
-                bpm = *tmp_bpm;
-                //DBG("Got BPM");
-            }
-            else
+        if (auto* playHead = getPlayHead())
+        {
+            if (auto position = playHead->getPosition())
             {
-                //DBG("Host BPM could not be retrieved");
-                bpm = 120.0;
+                bpm = position->getBpm().orFallback(120.0);
+
+                if (position->getIsPlaying())
+                    ppq = position->getPpqPosition();
             }
+        }
 
+        if (params.rateChanged || bpm != currentBpm)
+        {
+            currentBpm = bpm;
             myOsc.setBpm(bpm);
 
-            auto rate = myOsc.setModulator(noteIndex, feelIndex, true);
-
+            auto rate = myOsc.setModulator(params.noteIndex, params.feelIndex, true);
 
             myOsc.setFrequency(rate);
+        }
 
+        // While the transport runs, every sample's phase is worked out from the
+        // block's song position plus the beats since its start, so the LFO stays
+        // locked to the bar through loops and seeks and renders the same online,
+        // offline and at any block size. Stopped, it runs on from where it was.
+        if (ppq.hasValue())
+            myOsc.syncToPpq(*ppq, bpm, getSampleRate(), params.noteIndex, params.feelIndex);
+        else
+            myOsc.releaseSync();
+    }
+    else
+    {
+        myOsc.releaseSync();
 
+        // Coming out of sync the LFO jumps straight to the free rate, later
+        // changes to it are ramped
+        if (currentBpm != 0.0)
+        {
+            currentBpm = 0.0;
+            rateRamp.setCurrentAndTargetValue(params.rate);
+            myOsc.setFrequency(params.rate);
+        }
+        else if (params.rateChanged)
+        {
+            rateRamp.setTargetValue(params.rate);
+        }
+    }
 
-            for (int channel = 0; channel < totalNumInputChannels; ++channel)
-            {
-                auto* channelData = buffer.getWritePointer(channel);
 
-                for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-                {
-                    float modulation = 1.0f - depth * myOsc.processSample();
-                    channelData[sample] *= modulation;
-                }
+    updateModulationRoutes();
+
+    // Spreading LFO 1 only changes the tremolo, so it costs nothing unless
+    // LFO 1 reaches Volume on more than one channel
+    lfoSpread.setOffset(juce::degreesToRadians(params.phaseOffset));
+
+    spreadChannels = lfoSpread.isActive() && modMatrix.isRouted(ModSource_Lfo1, ModDest_Volume)
+                  && totalNumInputChannels > 1 && totalNumInputChannels <= channelTremolo.getNumChannels()
+                   ? totalNumInputChannels : 0;
+
+    path.pipeline.update(params.gain);
+
+    // The filter runs in LowPass mode, or in any mode while a route modulates its cutoff
+    auto filterActive = mod != 0 || modMatrix.isActive(ModDest_Cutoff);
+
+    if (filterActive)
+    {
+        if (lowPassDesigner.pull())
+            updateLowPassFilter(lowPassDesigner.getCoefficients());
+
+        // A static cutoff runs the designed Butterworth biquads, a modulated one
+        // the state variable filter, which tolerates per-sub-block cutoff changes.
+        // A route fading out keeps modulating until it has reached zero.
+        auto sweep = modMatrix.isActive(ModDest_Cutoff);
+
+        if (sweep != sweepActive)
+        {
+            sweepActive = sweep;
+
+            if (sweepActive)
+                path.lowPass.resetSweep();
+            else
+            {
+                path.lowPass.resetBiquads();
+                requestLowPassDesign();
             }
         }
-        else // LowPassFilter modulation
-        {
+    }
 
-            /*
-            auto rate = apvts.getRawParameterValue("rate")->load();
+    auto maxChunk = modulationBuffer.getNumSamples();
+    auto captureTelemetry = telemetry.isEnabled();
 
+    jassert(maxChunk > 0); // prepareToPlay hasn't been called
+    if (maxChunk == 0)
+        return;
 
-           // myOsc.setFrequency(rate);
-            myLfo.setFrequency(0.5f);
+    // InSync only affects the LFO rate above. The sources are rendered once per
+    // chunk and shared by every channel, so all channels stay in phase; only
+    // LFO 1's tremolo can be spread across them by the Phase Offset.
+    for (int start = 0; start < numSamples; start += maxChunk)
+    {
+        auto num = juce::jmin(maxChunk, numSamples - start);
+        auto block = inputBlock.getSubBlock((size_t) start, (size_t) num);
 
+        renderModulation(num);
 
-            for (int channel = 0; channel < totalNumInputChannels; ++channel)
-            {
-                auto* channelData = buffer.getWritePointer(channel);
+        if (captureTelemetry)
+            captureModulation(num);
 
-                for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-                {
-                    // Process LFO or other modulation signal here
-                    float lfoSample = myLfo.processSample(); // or another modulation source
+        renderNodeControl(num, filterActive);
 
-                    // Calculate modulated frequency, for example using depth to control the modulation amount
-                    float baseFrequency = 440.0f;  // Default base frequency (e.g., A4)
-                    float modulatedFrequency = baseFrequency + (lfoSample * lowPassCut);  // Modulate frequency
+        juce::dsp::ProcessContextReplacing<SampleType> context(block);
+        path.pipeline.process(context);
 
-                    // Clamp modulated frequency to avoid invalid values
-                    modulatedFrequency = std::max(20.0f, std::min(modulatedFrequency, 20000.0f));  // Ensure valid range
+        if (captureTelemetry)
+            telemetry.captureOutput(block);
+    }
+} 
 
-                    // Set the modulated frequency to the oscillator
-                    myOsc.setFrequency(0.5f);
+void BasicOscillatorAudioProcessor::applyProgram(int index)
+{
+    auto& program = ProgramBank::getProgram(index);
+    auto& state = programBank.getPreparedState(index);
+
+    // Hold the program's values for up to half a second while the parameters catch up
+    auto maxBlocks = juce::jmax(1, (int) (0.5 * getSampleRate() / juce::jmax(1, getBlockSize())));
+    params.pin(program, maxBlocks);
+
+    // The filter jumps straight to the program's ready-made coefficients;
+    // everything else follows from the pinned values like any other change
+    lowPassDesigner.setCoefficients(state.lowPass);
+    updateLowPassFilter(state.lowPass);
+    cutoffRamp.setCurrentAndTargetValue(state.cutoffOctave);
+    setLowPassSlope(program.lowPassSlope);
+    myOsc.setLowPassFreq(program.lowPassFreq);
+
+    currentProgram.store(index);
+}
 
-                    // Now process the sample with the oscillator, outputting to the channel data
-                    channelData[sample] = myOsc.processSample();  // Get the oscillator's output for this sample
+void BasicOscillatorAudioProcessor::setParametersFromProgram(int index)
+{
+    auto& program = ProgramBank::getProgram(index);
 
-                    DBG("Modulated Frequency: " << modulatedFrequency);
-                    DBG("lfosample: " << lfoSample);
+    auto set = [this](const char* id, float value)
+    {
+        if (auto* param = apvts.getParameter(id))
+            PluginState::setIfChanged(*param, value);
+    };
+
+    set(ParamID::Modulation, (float) program.modulation);
+    set(ParamID::InSync, program.inSync ? 1.0f : 0.0f);
+    set(ParamID::NoteVal, (float) program.noteIndex);
+    set(ParamID::Feel, (float) program.feelIndex);
+    set(ParamID::OscShape, (float) program.waveIndex);
+    set(ParamID::Rate, program.rate);
+    set(ParamID::Depth, program.depth);
+    set(ParamID::LowPass, program.lowPassFreq);
+    set(ParamID::LowPassSlope, (float) program.lowPassSlope);
+
+    currentProgram.store(index);
+}
 
-                }
-            }
-            */
+void BasicOscillatorAudioProcessor::timerCallback()
+{
+    auto index = programToPublish.exchange(-1);
+
+    if (index >= 0)
+    {
+        setParametersFromProgram(index);
+        updateHostDisplay(ChangeDetails().withProgramChanged(true));
+    }
+
+    if (loadLog != nullptr)
+        writeLoadLog();
+}
+
+void BasicOscillatorAudioProcessor::setLoadLogFile(const juce::File& file)
+{
+    loadLog = file == juce::File() ? nullptr : openLoadLog(file);
+    lastLoggedWindow = loadMeter.getStats().window;
+    updateTimer();
+}
+
+void BasicOscillatorAudioProcessor::updateTimer()
+{
+    // Program changes only arrive on the audio thread while the processor is
+    // prepared, so an instance that is merely loaded, or released, never
+    // wakes the message thread unless it is logging
+    if (prepared || loadLog != nullptr)
+    {
+        if (! isTimerRunning())
+            startTimerHz(20);
+    }
+    else
+    {
+        stopTimer();
+    }
+}
+
+void BasicOscillatorAudioProcessor::writeLoadLog()
+{
+    auto stats = loadMeter.getStats();
+
+    if (stats.window == lastLoggedWindow)
+        return;
+
+    lastLoggedWindow = stats.window;
+
+    auto* object = new juce::DynamicObject();
+    object->setProperty("instance", instanceId);
+    object->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+    object->setProperty("sample_rate", getSampleRate());
+    object->setProperty("block_size", getBlockSize());
+    object->setProperty("block_p50_us", stats.p50Us);
+    object->setProperty("block_p99_us", stats.p99Us);
+    object->setProperty("block_max_us", stats.maxUs);
+    object->setProperty("average_load", stats.averageLoad);
+    object->setProperty("peak_load", stats.peakLoad);
+
+    *loadLog << juce::JSON::toString(juce::var(object), true) << "\n";
+    loadLog->flush();
+}
 
-            juce::dsp::ProcessContextReplacing<float> leftContext(leftBlock);
-            juce::dsp::ProcessContextReplacing<float> rightContext(rightBlock);
+void BasicOscillatorAudioProcessor::updateModulationRoutes()
+{
+    // The Modulation choice and depth drive LFO 1's Volume or Cutoff route,
+    // on top of whatever the matrix sets for it, together never past full depth
+    auto legacyDestination = params.modulation == 0 ? ModDest_Volume : ModDest_Cutoff;
 
-            leftChain.process(leftContext);
-            rightChain.process(rightContext);
+    for (int source = 0; source < NumModSources; ++source)
+    {
+        for (int destination = 0; destination < NumModDestinations; ++destination)
+        {
+            auto depth = params.routeDepths[(size_t) (source * NumModDestinations + destination)];
 
-            auto chainSettings = getChainSettings(apvts);
+            if (source == ModSource_Lfo1 && destination == legacyDestination)
+                depth += params.depth;
 
+            modMatrix.setDepth(source, destination, juce::jlimit(0.0f, 1.0f, depth));
+        }
+    }
 
-            auto cutCoefficients = juce::dsp::FilterDesign<float>::designIIRLowpassHighOrderButterworthMethod(chainSettings.highCutFreq, getSampleRate(), 2 * (chainSettings.highCutSlope + 1));
+    modMatrix.updateRoutes();
+}
 
-            auto& leftHighCut = leftChain.get<ChainPositions::HighCut>();
-            auto& rightHighCut = rightChain.get<ChainPositions::HighCut>();
+void BasicOscillatorAudioProcessor::renderModulation(int numSamples)
+{
+    const float* sources[NumModSources] {};
 
+    if (modMatrix.usesSource(ModSource_Lfo1))
+    {
+        renderLfo(modulationBuffer.getWritePointer(0), numSamples);
+        sources[ModSource_Lfo1] = modulationBuffer.getReadPointer(0);
+    }
 
-            leftHighCut.setBypassed<0>(true);
-            leftHighCut.setBypassed<1>(true);
+    // The extra LFOs are rendered together, so using one costs the same as both
+    if (modMatrix.usesSource(ModSource_Lfo2) || modMatrix.usesSource(ModSource_Lfo3))
+    {
+        lfoBank.render(numSamples);
+        sources[ModSource_Lfo2] = lfoBank.getOutput(0);
+        sources[ModSource_Lfo3] = lfoBank.getOutput(1);
+    }
 
+    modMatrix.process(sources, numSamples);
+}
 
-            switch (chainSettings.highCutSlope)
-            {
-            case Slope_12:
-            {
-                *leftHighCut.get<0>().coefficients = *cutCoefficients[0];
-                leftHighCut.setBypassed<0>(false);
-                break;
-            }
-            case Slope_24:
-            {
-                *leftHighCut.get<0>().coefficients = *cutCoefficients[0];
-                leftHighCut.setBypassed<0>(false);
-                *leftHighCut.get<1>().coefficients = *cutCoefficients[1];
-                leftHighCut.setBypassed<1>(false);
-                break;
-            }
-            }
+void BasicOscillatorAudioProcessor::captureModulation(int numSamples)
+{
+    // The scope shows the first destination anything is routed to, before
+    // the stages below turn it into a gain or cutoff in place
+    const float* modulation = nullptr;
 
-            rightHighCut.setBypassed<0>(true);
-            rightHighCut.setBypassed<1>(true);
+    for (int destination = 0; destination < NumModDestinations && modulation == nullptr; ++destination)
+        modulation = modMatrix.getOutput(destination);
 
-            switch (chainSettings.highCutSlope)
-            {
-            case Slope_12:
-            {
-                *rightHighCut.get<0>().coefficients = *cutCoefficients[0];
-                rightHighCut.setBypassed<0>(false);
-                break;
-            }
-            case Slope_24:
-            {
-                *rightHighCut.get<0>().coefficients = *cutCoefficients[0];
-                rightHighCut.setBypassed<0>(false);
-                *rightHighCut.get<1>().coefficients = *cutCoefficients[1];
-                rightHighCut.setBypassed<1>(false);
-                break;
-            }
-            }
+    auto* lfo = modMatrix.usesSource(ModSource_Lfo1) ? modulationBuffer.getReadPointer(0) : nullptr;
 
+    telemetry.captureControl(lfo, modulation, numSamples);
+}
 
+void BasicOscillatorAudioProcessor::updateLowPassFilter(const CascadeCoefficients& coefficients)
+{
+    forEachPath([&](auto& path) { path.lowPass.setCoefficients(coefficients); });
+}
 
-        }
+void BasicOscillatorAudioProcessor::setLowPassSlope(int slope)
+{
+    forEachPath([=](auto& path) { path.lowPass.setSlope(slope); });
+}
+
+void BasicOscillatorAudioProcessor::renderLfo(float* dest, int numSamples)
+{
+    // Synced, the rate follows the tempo; free running it comes from the rate ramp
+    auto* rates = params.inSync ? nullptr : rateRamp.advance(numSamples);
+
+    // Spread, the one accumulator's phases are evaluated at every channel's
+    // offset, and channel 0, which has none, is LFO 1 itself
+    if (spreadChannels > 0)
+    {
+        myOsc.renderPhases(lfoSpread.getPhaseBuffer(), numSamples, rates);
+        lfoSpread.render(spreadChannels, numSamples);
+        juce::FloatVectorOperations::copy(dest, lfoSpread.getOutput(0), numSamples);
     }
+    else if (rates != nullptr)
+        myOsc.renderBlock(dest, numSamples, rates);
     else
+        myOsc.renderBlock(dest, numSamples);
+}
+
+void BasicOscillatorAudioProcessor::followCutoffRamp(int numSamples)
+{
+    // Outside the sweep the biquads follow a moving cutoff at block rate
+    if (cutoffRamp.isSmoothing())
     {
-        //INSYNC IS OFF =================================================================================
-        if (mod == 0) //Volume
-        {
-            auto rate = apvts.getRawParameterValue("rate")->load();
+        cutoffRamp.skip(numSamples);
+        requestLowPassDesign();
+    }
+}
 
+void BasicOscillatorAudioProcessor::requestLowPassDesign()
+{
+    // A settled ramp holds log2 of the cutoff, which doesn't convert back bit
+    // for bit. Asking for the parameter itself then matches what prepareToPlay
+    // designed, and the designer drops the request.
+    auto freq = cutoffRamp.isSmoothing() ? std::exp2(cutoffRamp.getCurrentValue()) : params.lowPassFreq;
+    lowPassDesigner.request(freq, params.lowPassSlope);
+}
 
-            myOsc.setFrequency(rate);
+void BasicOscillatorAudioProcessor::renderNodeControl(int numSamples, bool filterActive)
+{
+    nodeControl.tremoloGain = nullptr;
+    nodeControl.channelTremoloGains = nullptr;
 
+    // gain = 1 - sum of depth * lfo. Several routes can sum past full depth,
+    // so the gain stops at silence rather than flipping the polarity.
+    if (auto* volume = modMatrix.getOutput(ModDest_Volume))
+    {
+        juce::FloatVectorOperations::negate(volume, volume, numSamples);
+        juce::FloatVectorOperations::add(volume, 1.0f, numSamples);
+        juce::FloatVectorOperations::max(volume, volume, 0.0f, numSamples);
+        nodeControl.tremoloGain = volume;
 
+        // Every other channel sums Volume again with its own copy of LFO 1
+        if (spreadChannels > 0)
+        {
+            channelTremoloGains[0] = volume;
 
-            for (int channel = 0; channel < totalNumInputChannels; ++channel)
+            for (int ch = 1; ch < spreadChannels; ++ch)
             {
-                auto* channelData = buffer.getWritePointer(channel);
+                auto* gain = channelTremolo.getWritePointer(ch);
 
-                for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
-                {
-                    float modulation = 1.0f - depth * myOsc.processSample();
-                    channelData[sample] *= modulation;
-                }
+                modMatrix.renderWithSource(ModDest_Volume, ModSource_Lfo1, lfoSpread.getOutput(ch), gain, numSamples);
+                juce::FloatVectorOperations::negate(gain, gain, numSamples);
+                juce::FloatVectorOperations::add(gain, 1.0f, numSamples);
+                juce::FloatVectorOperations::max(gain, gain, 0.0f, numSamples);
+                channelTremoloGains[(size_t) ch] = gain;
             }
-        }
-        else // LowPass Filter modulation
-        {
-           
+
+            nodeControl.tremoloGain = nullptr;
+            nodeControl.channelTremoloGains = channelTremoloGains.data();
         }
     }
 
-    /*
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
-    lowPassFilter.process(context);
-  */
-} 
+    // Ahead of a filter the tremolo has to run on its own, otherwise it is
+    // folded into the output gain pass
+    nodeControl.tremoloBeforeFilter = filterActive && nodeControl.hasTremolo();
+    nodeControl.filterActive = filterActive;
+    nodeControl.cutoffOctaves = nullptr;
+
+    if (filterActive && sweepActive)
+        nodeControl.cutoffOctaves = renderCutoffSweep(modMatrix.getOutput(ModDest_Cutoff), numSamples);
+    else
+        followCutoffRamp(numSamples);
+
+    nodeControl.outputGain = renderOutputGain(modMatrix.getOutput(ModDest_Gain), modMatrix.getOutput(ModDest_Phase), numSamples);
+}
+
+float* BasicOscillatorAudioProcessor::renderCutoffSweep(float* cutoffModulation, int numSamples)
+{
+    // The routes pull the cutoff down from the LowPass setting by up to
+    // sweepOctaves per unit of depth. Working in octaves keeps the sweep
+    // exponential in Hz with no log2 on the audio thread, and only the
+    // control points the filter reads are mapped.
+    auto* baseOctaves = cutoffRamp.advance(numSamples);
+
+    for (int i = 0; i < numSamples; i += SvfLowPass<float>::controlInterval)
+    {
+        auto baseOctave = baseOctaves != nullptr ? baseOctaves[i] : cutoffRamp.getCurrentValue();
+        cutoffModulation[i] = baseOctave - sweepOctaves * cutoffModulation[i];
+    }
+
+    return cutoffModulation;
+}
+
+const float* BasicOscillatorAudioProcessor::renderOutputGain(float* gainModulation, float* phaseModulation, int numSamples)
+{
+    // Gain dips the level by up to its depth, Phase swings the polarity from
+    // + through silence to - at full depth. Routes summing past full depth
+    // stop at silence and full inversion respectively.
+    if (gainModulation != nullptr)
+    {
+        juce::FloatVectorOperations::negate(gainModulation, gainModulation, numSamples);
+        juce::FloatVectorOperations::add(gainModulation, 1.0f, numSamples);
+        juce::FloatVectorOperations::max(gainModulation, gainModulation, 0.0f, numSamples);
+    }
+
+    if (phaseModulation != nullptr)
+    {
+        juce::FloatVectorOperations::multiply(phaseModulation, -2.0f, numSamples);
+        juce::FloatVectorOperations::add(phaseModulation, 1.0f, numSamples);
+        juce::FloatVectorOperations::max(phaseModulation, phaseModulation, -1.0f, numSamples);
+
+        if (gainModulation != nullptr)
+            juce::FloatVectorOperations::multiply(gainModulation, phaseModulation, numSamples);
+    }
+
+    return gainModulation != nullptr ? gainModulation : phaseModulation;
+}
 
 //==============================================================================
 bool BasicOscillatorAudioProcessor::hasEditor() const
@@ -422,21 +738,24 @@ bool BasicOscillatorAudioProcessor::hasEditor() const
 
 juce::AudioProcessorEditor* BasicOscillatorAudioProcessor::createEditor()
 {
-    return new juce::GenericAudioProcessorEditor(*this);
+    return new BasicOscillatorAudioProcessorEditor(*this);
 }
 
 //==============================================================================
 void BasicOscillatorAudioProcessor::getStateInformation (juce::MemoryBlock& destData)
 {
-    // You should use this method to store your parameters in the memory block.
-    // You could do that either as raw data, or use the XML or ValueTree classes
-    // as intermediaries to make it easy to save and load complex data.
+    PluginState::write(apvts, currentProgram.load(), destData);
 }
 
 void BasicOscillatorAudioProcessor::setStateInformation (const void* data, int sizeInBytes)
 {
-    // You should use this method to restore your parameters from this memory block,
-    // whose contents will have been created by the getStateInformation() call.
+    // Unrecognised data leaves the parameters as they are. The saved program
+    // is only selected again: the parameters restored with it may have been
+    // edited since, so its own values aren't applied.
+    auto program = currentProgram.load();
+
+    if (PluginState::read(apvts, data, sizeInBytes, program) && juce::isPositiveAndBelow(program, ProgramBank::numPrograms))
+        currentProgram.store(program);
 }
 
 OscWaveforms BasicOscillatorAudioProcessor::setOscillatorWaveform(int waveIndex)
@@ -464,18 +783,162 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts)
 {
     ChainSettings settings;
 
-    settings.highCutFreq = static_cast<Slope>(apvts.getRawParameterValue("LowPass")->load());
-    settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue("LowPass Slope")->load());
+    settings.highCutFreq = apvts.getRawParameterValue(ParamID::LowPass)->load();
+    settings.highCutSlope = static_cast<Slope>(apvts.getRawParameterValue(ParamID::LowPassSlope)->load());
 
     return settings;
 }
 
+//==============================================================================
+ParameterSnapshot::ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts)
+    : inSyncParam(apvts.getRawParameterValue(ParamID::InSync)),
+      modulationParam(apvts.getRawParameterValue(ParamID::Modulation)),
+      noteValParam(apvts.getRawParameterValue(ParamID::NoteVal)),
+      feelParam(apvts.getRawParameterValue(ParamID::Feel)),
+      oscShapeParam(apvts.getRawParameterValue(ParamID::OscShape)),
+      rateParam(apvts.getRawParameterValue(ParamID::Rate)),
+      depthParam(apvts.getRawParameterValue(ParamID::Depth)),
+      phaseOffsetParam(apvts.getRawParameterValue(ParamID::PhaseOffset)),
+      lowPassParam(apvts.getRawParameterValue(ParamID::LowPass)),
+      lowPassSlopeParam(apvts.getRawParameterValue(ParamID::LowPassSlope)),
+      gainParam(apvts.getRawParameterValue(MODID::Gain)),
+      gainBypassParam(apvts.getRawParameterValue(MODID::GainBypass)),
+      gainPhaseParam(apvts.getRawParameterValue(MODID::GainPhase))
+{
+    jassert(inSyncParam != nullptr && modulationParam != nullptr && noteValParam != nullptr
+         && feelParam != nullptr && oscShapeParam != nullptr && rateParam != nullptr
+         && depthParam != nullptr && phaseOffsetParam != nullptr && lowPassParam != nullptr
+         && lowPassSlopeParam != nullptr && gainParam != nullptr && gainBypassParam != nullptr
+         && gainPhaseParam != nullptr);
+
+    for (size_t i = 0; i < (size_t) numExtraLfos; ++i)
+    {
+        extraLfoRateParams[i] = apvts.getRawParameterValue(ParamID::ExtraLfoRate[i]);
+        extraLfoShapeParams[i] = apvts.getRawParameterValue(ParamID::ExtraLfoShape[i]);
+        jassert(extraLfoRateParams[i] != nullptr && extraLfoShapeParams[i] != nullptr);
+    }
+
+    for (int source = 0; source < NumModSources; ++source)
+    {
+        for (int destination = 0; destination < NumModDestinations; ++destination)
+        {
+            auto& param = routeParams[(size_t) (source * NumModDestinations + destination)];
+            param = apvts.getRawParameterValue(ParamID::route(source, destination));
+            jassert(param != nullptr);
+        }
+    }
+}
+
+void ParameterSnapshot::update() noexcept
+{
+    updateMatrix();
+
+    if (pinnedBlocks > 0)
+    {
+        if (--pinnedBlocks > 0 && ! matchesPinnedValues())
+        {
+            rateChanged = false;
+            waveChanged = false;
+            filterChanged = false;
+            return;
+        }
+
+        pinnedBlocks = 0;
+    }
+
+    auto newInSync = inSyncParam->load() >= 0.5f;
+    auto newNoteIndex = static_cast<int>(noteValParam->load());
+    auto newFeelIndex = static_cast<int>(feelParam->load());
+    auto newRate = rateParam->load();
+    auto newWaveIndex = static_cast<int>(oscShapeParam->load());
+    auto newLowPassFreq = lowPassParam->load();
+    auto newLowPassSlope = static_cast<int>(lowPassSlopeParam->load());
+
+    modulation = static_cast<int>(modulationParam->load());
+    depth = depthParam->load();
+
+    rateChanged = dirty || newInSync != inSync || newNoteIndex != noteIndex
+               || newFeelIndex != feelIndex || newRate != rate;
+    waveChanged = dirty || newWaveIndex != waveIndex;
+    filterChanged = dirty || newLowPassFreq != lowPassFreq || newLowPassSlope != lowPassSlope;
+    dirty = false;
+
+    inSync = newInSync;
+    noteIndex = newNoteIndex;
+    feelIndex = newFeelIndex;
+    rate = newRate;
+    waveIndex = newWaveIndex;
+    lowPassFreq = newLowPassFreq;
+    lowPassSlope = newLowPassSlope;
+}
+
+void ParameterSnapshot::updateMatrix() noexcept
+{
+    extraLfosChanged = dirty;
+
+    for (size_t i = 0; i < (size_t) numExtraLfos; ++i)
+    {
+        auto newLfoRate = extraLfoRateParams[i]->load();
+        auto newLfoShape = static_cast<int>(extraLfoShapeParams[i]->load());
+
+        extraLfosChanged = extraLfosChanged || newLfoRate != extraLfoRates[i] || newLfoShape != extraLfoShapes[i];
+        extraLfoRates[i] = newLfoRate;
+        extraLfoShapes[i] = newLfoShape;
+    }
+
+    // Route depths are compared by the matrix itself
+    for (size_t i = 0; i < routeParams.size(); ++i)
+        routeDepths[i] = routeParams[i]->load();
+
+    // Not part of the programs, so never pinned
+    phaseOffset = phaseOffsetParam->load();
+
+    gain.gainDecibels = gainParam->load();
+    gain.bypassed = gainBypassParam->load() >= 0.5f;
+    gain.invertPhase = gainPhaseParam->load() >= 0.5f;
+}
+
+void ParameterSnapshot::pin(const ProgramPreset& program, int maxBlocks) noexcept
+{
+    modulation = program.modulation;
+    inSync = program.inSync;
+    noteIndex = program.noteIndex;
+    feelIndex = program.feelIndex;
+    waveIndex = program.waveIndex;
+    rate = program.rate;
+    depth = program.depth;
+    lowPassFreq = program.lowPassFreq;
+    lowPassSlope = program.lowPassSlope;
+
+    // The caller applies the program's filter itself
+    rateChanged = true;
+    waveChanged = true;
+    filterChanged = false;
+
+    pinnedBlocks = maxBlocks;
+}
+
+bool ParameterSnapshot::matchesPinnedValues() const noexcept
+{
+    auto near = [](float value, float target) { return std::abs(value - target) <= 1.0e-4f * juce::jmax(1.0f, std::abs(target)); };
+
+    return (inSyncParam->load() >= 0.5f) == inSync
+        && static_cast<int>(modulationParam->load()) == modulation
+        && static_cast<int>(noteValParam->load()) == noteIndex
+        && static_cast<int>(feelParam->load()) == feelIndex
+        && static_cast<int>(oscShapeParam->load()) == waveIndex
+        && static_cast<int>(lowPassSlopeParam->load()) == lowPassSlope
+        && near(rateParam->load(), rate)
+        && near(depthParam->load(), depth)
+        && near(lowPassParam->load(), lowPassFreq);
+}
+
 
 juce::AudioProcessorValueTreeState::ParameterLayout BasicOscillatorAudioProcessor::createParameterLayout()
 {
     juce::AudioProcessorValueTreeState::ParameterLayout layout;
 
-    layout.add(std::make_unique<juce::AudioParameterBool>("InSync", "InSync", true)); //In Sync with BPM
+    layout.add(std::make_unique<juce::AudioParameterBool>(ParamID::InSync, "InSync", true)); //In Sync with BPM
 
 
     juce::StringArray stringArray4;
@@ -483,7 +946,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout BasicOscillatorAudioProcesso
     stringArray4.add("LowPass Filter"); //Index 1
 
 
-    layout.add(std::make_unique<juce::AudioParameterChoice>("Modulation", "Modulation", stringArray4, 0)); //Choice
+    layout.add(std::make_unique<juce::AudioParameterChoice>(ParamID::Modulation, "Modulation", stringArray4, 0)); //Choice
 
 
 
@@ -497,7 +960,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout BasicOscillatorAudioProcesso
     stringArray2.add("1/32");
 
 
-    layout.add(std::make_unique<juce::AudioParameterChoice>("NoteVal", "NoteVal", stringArray2, 0)); //BPM
+    layout.add(std::make_unique<juce::AudioParameterChoice>(ParamID::NoteVal, "NoteVal", stringArray2, 0)); //BPM
 
     
     juce::StringArray stringArray3;
@@ -506,7 +969,7 @@ juce::AudioProcessorValueTreeState::ParameterLayout BasicOscillatorAudioProcesso
     stringArray3.add("Triplet");
 
 
-    layout.add(std::make_unique<juce::AudioParameterChoice>("Feel", "Feel", stringArray3, 0)); //BPM
+    layout.add(std::make_unique<juce::AudioParameterChoice>(ParamID::Feel, "Feel", stringArray3, 0)); //BPM
     
 
 
@@ -517,16 +980,17 @@ juce::AudioProcessorValueTreeState::ParameterLayout BasicOscillatorAudioProcesso
     stringArray.add("SawTooth");
 
 
-    layout.add(std::make_unique<juce::AudioParameterChoice>("OscShape", "OscShape", stringArray, 0)); //Shape of Wave
+    layout.add(std::make_unique<juce::AudioParameterChoice>(ParamID::OscShape, "OscShape", stringArray, 0)); //Shape of Wave
 
 
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>("rate", "Rate", 0.1f, 10.0f, 5.0f));  // Rate: min 0.1Hz, max 10Hz, default 5Hz
-    layout.add(std::make_unique<juce::AudioParameterFloat>("depth", "Depth", 0.0f, 1.0f, 0.5f)); // Depth: min 0.0, max 1.0, default 0.5
+    layout.add(std::make_unique<juce::AudioParameterFloat>(ParamID::Rate, "Rate", 0.1f, 10.0f, 5.0f));  // Rate: min 0.1Hz, max 10Hz, default 5Hz
+    layout.add(std::make_unique<juce::AudioParameterFloat>(ParamID::Depth, "Depth", 0.0f, 1.0f, 0.5f)); // Depth: min 0.0, max 1.0, default 0.5
+    layout.add(std::make_unique<juce::AudioParameterFloat>(ParamID::PhaseOffset, "Phase Offset", juce::NormalisableRange<float>(0.0f, 359.0f, 1.0f), 0.0f)); // LFO 1 phase between neighbouring channels in whole degrees, [0, 360); 180 auto-pans stereo
 
    
 
-    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID("LowPass", 1), "LowPass", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 20000.f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>(juce::ParameterID(ParamID::LowPass, 1), "LowPass", juce::NormalisableRange<float>(20.f, 20000.f, 1.f, 0.25f), 20000.f));
 
 
     juce::StringArray stringArray5;
@@ -538,8 +1002,29 @@ juce::AudioProcessorValueTreeState::ParameterLayout BasicOscillatorAudioProcesso
         stringArray5.add(str);
     }
 
-    layout.add(std::make_unique<juce::AudioParameterChoice>("LowPass Slope", "LowPass Slope", stringArray5, 0)); //Shape of Wave
+    layout.add(std::make_unique<juce::AudioParameterChoice>(ParamID::LowPassSlope, "LowPass Slope", stringArray5, 0)); //Shape of Wave
+
+
+    for (int i = 0; i < numExtraLfos; ++i)
+    {
+        auto name = ModSourceNames[i + 1];
+
+        layout.add(std::make_unique<juce::AudioParameterFloat>(ParamID::ExtraLfoRate[i], name + " Rate", 0.1f, 10.0f, 1.0f));
+        layout.add(std::make_unique<juce::AudioParameterChoice>(ParamID::ExtraLfoShape[i], name + " Shape", stringArray, 0));
+    }
+
+
+    // One depth per source and destination; LFO 1's Volume or Cutoff depth adds to Depth above
+    for (int source = 0; source < NumModSources; ++source)
+        for (int destination = 0; destination < NumModDestinations; ++destination)
+            layout.add(std::make_unique<juce::AudioParameterFloat>(ParamID::route(source, destination),
+                                                                   ModSourceNames[source] + " > " + ModDestinationNames[destination],
+                                                                   0.0f, 1.0f, 0.0f));
+
 
+    auto gainGroup = std::make_unique<juce::AudioProcessorParameterGroup>("Output", "Output", "|");
+    addGainParams(*gainGroup);
+    layout.add(std::move(gainGroup));
 
     
     return layout;
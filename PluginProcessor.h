@@ -10,6 +10,16 @@
 
 #include <JuceHeader.h>
 #include "Oscillator.hpp"
+#include "LfoBank.hpp"
+#include "LfoSpread.hpp"
+#include "StaticPipeline.hpp"
+#include "SignalNodes.hpp"
+#include "ModulationMatrix.hpp"
+#include "PluginState.hpp"
+#include "ProgramBank.hpp"
+#include "Telemetry.hpp"
+#include "LoadMeter.hpp"
+#include "ParameterRamp.hpp"
 
 
 enum Slope
@@ -21,6 +31,96 @@ enum Slope
 };
 
 
+namespace ParamID
+{
+    constexpr const char* InSync       { "InSync" };
+    constexpr const char* Modulation   { "Modulation" };
+    constexpr const char* NoteVal      { "NoteVal" };
+    constexpr const char* Feel         { "Feel" };
+    constexpr const char* OscShape     { "OscShape" };
+    constexpr const char* Rate         { "rate" };
+    constexpr const char* Depth        { "depth" };
+    constexpr const char* PhaseOffset  { "PhaseOffset" };
+    constexpr const char* LowPass      { "LowPass" };
+    constexpr const char* LowPassSlope { "LowPass Slope" };
+
+    // LFO 2 and LFO 3, run by the LFO bank
+    constexpr const char* ExtraLfoRate[]  { "Lfo2Rate", "Lfo3Rate" };
+    constexpr const char* ExtraLfoShape[] { "Lfo2Shape", "Lfo3Shape" };
+
+    // Modulation matrix depth, e.g. "RouteLFO2Cutoff"
+    inline juce::String route(int source, int destination)
+    {
+        return "Route" + ModSourceNames[source].removeCharacters(" ") + ModDestinationNames[destination];
+    }
+}
+
+constexpr int numExtraLfos = NumModSources - 1;
+
+//==============================================================================
+/**
+    Plain copy of the parameters used by processBlock. The raw parameter
+    pointers are resolved once at construction, so update() is just a handful
+    of atomic loads, and the dirty flags tell the audio thread which derived
+    state (waveform, LFO rate, filter coefficients) needs recomputing.
+*/
+struct ParameterSnapshot
+{
+    explicit ParameterSnapshot(juce::AudioProcessorValueTreeState& apvts);
+
+    void update() noexcept;
+
+    void markAllDirty() noexcept { dirty = true; pinnedBlocks = 0; }
+
+    // Takes a program's values straight away and holds them, for at most
+    // maxBlocks updates, until the parameters have been set to match
+    void pin(const ProgramPreset& program, int maxBlocks) noexcept;
+
+    bool inSync{ true };
+    int modulation{ 0 };
+    int noteIndex{ 0 };
+    int feelIndex{ 0 };
+    int waveIndex{ 0 };
+    float rate{ 5.f };
+    float depth{ 0.5f };
+    float phaseOffset{ 0.f };
+    float lowPassFreq{ 20000.f };
+    int lowPassSlope{ Slope::Slope_12 };
+    std::array<float, numExtraLfos> extraLfoRates{};
+    std::array<int, numExtraLfos> extraLfoShapes{};
+    std::array<float, ModulationMatrix::numCells> routeDepths{};
+    GainSettings gain;
+
+    bool rateChanged{ true };
+    bool waveChanged{ true };
+    bool filterChanged{ true };
+    bool extraLfosChanged{ true };
+
+private:
+    std::atomic<float>* inSyncParam;
+    std::atomic<float>* modulationParam;
+    std::atomic<float>* noteValParam;
+    std::atomic<float>* feelParam;
+    std::atomic<float>* oscShapeParam;
+    std::atomic<float>* rateParam;
+    std::atomic<float>* depthParam;
+    std::atomic<float>* phaseOffsetParam;
+    std::atomic<float>* lowPassParam;
+    std::atomic<float>* lowPassSlopeParam;
+    std::atomic<float>* gainParam;
+    std::atomic<float>* gainBypassParam;
+    std::atomic<float>* gainPhaseParam;
+    std::array<std::atomic<float>*, numExtraLfos> extraLfoRateParams{};
+    std::array<std::atomic<float>*, numExtraLfos> extraLfoShapeParams{};
+    std::array<std::atomic<float>*, ModulationMatrix::numCells> routeParams{};
+
+    bool dirty{ true };
+    int pinnedBlocks{ 0 };
+
+    bool matchesPinnedValues() const noexcept;
+    void updateMatrix() noexcept;
+};
+
 struct ChainSettings
 {
     float highCutFreq{ 0 };
@@ -32,7 +132,8 @@ ChainSettings getChainSettings(juce::AudioProcessorValueTreeState& apvts);
 //==============================================================================
 /**
 */
-class BasicOscillatorAudioProcessor  : public juce::AudioProcessor
+class BasicOscillatorAudioProcessor  : public juce::AudioProcessor,
+                                       private juce::Timer
 {
 public:
     //==============================================================================
@@ -40,6 +141,9 @@ public:
     ~BasicOscillatorAudioProcessor() override;
 
     //==============================================================================
+    // Widest main bus accepted, e.g. seventh-order ambisonics
+    static constexpr int maxChannels = 64;
+
     void prepareToPlay (double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
 
@@ -48,6 +152,9 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock (juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -77,27 +184,149 @@ public:
 
     OscWaveforms BasicOscillatorAudioProcessor::setOscillatorWaveform(int waveIndex);
 
+    // Decimated LFO, modulation and output frames for the editor's scopes
+    Telemetry& getTelemetry() noexcept { return telemetry; }
+
+    // Block timing statistics, published once per LoadMeter::windowSeconds of audio
+    LoadMeter::Stats getLoadStats() const noexcept { return loadMeter.getStats(); }
+
+    // Appends one JSON line per published window to the file, or stops
+    // logging if it is invalid. Message thread only. The OSC_LOAD_LOG
+    // environment variable names a file to start with.
+    void setLoadLogFile(const juce::File& file);
+
 private:
    // float rate = 0.5f; //Modulation rate in Hz
    // float depth = 0.5f; //Modulation depth (0.0 to 1.0)
 
-   OscillatorProcessor myOsc;
+   ParameterSnapshot params{ apvts };
+
+   // Both overloads of processBlock share this body. Control signals (the
+   // LFOs, matrix and ramps) are always rendered in float; only the audio
+   // path below runs at the host's precision.
+   template <typename SampleType>
+   void processBlockImpl(juce::AudioBuffer<SampleType>& buffer, juce::MidiBuffer& midiMessages);
+
+   OscillatorProcessor<> myOsc;
 
-   OscillatorProcessor myLfo;
+   // LFO 2 and LFO 3, rendered together into one buffer each
+   LfoBank lfoBank;
 
-   using Filter = juce::dsp::IIR::Filter<float>;
+   // Scratch buffer holding LFO 1 for the current chunk, sized in prepareToPlay
+   juce::AudioBuffer<float> modulationBuffer;
 
-   using CutFilter = juce::dsp::ProcessorChain<Filter, Filter>;
+   // LFO 1 at the Phase Offset on each channel, with the tremolo it gives.
+   // Only used while the offset is non-zero and LFO 1 reaches Volume; the
+   // number of channels it runs on this block, otherwise 0.
+   LfoSpread lfoSpread;
+   juce::AudioBuffer<float> channelTremolo;
+   std::array<const float*, maxChannels> channelTremoloGains{};
+   int spreadChannels = 0;
 
-   using MonoChain = juce::dsp::ProcessorChain<CutFilter>;
+   ModulationMatrix modMatrix;
 
-   MonoChain leftChain, rightChain;
+   void updateModulationRoutes();
+   void renderModulation(int numSamples);
+   void captureModulation(int numSamples);
 
-   enum ChainPositions
+   Telemetry telemetry;
+
+   // Tempo the synced LFO rate was last computed for, 0 while free running
+   // and -1 until the first block after prepareToPlay
+   double currentBpm = -1.0;
+
+   // Per-block ramps for the LowPass cutoff and free LFO rate, so automation
+   // doesn't zipper; route depths are ramped by the matrix.
+   // The cutoff ramp runs in octaves, which makes it exponential in Hz.
+   static constexpr double rampSeconds = 0.02;
+
+   BlockRamp cutoffRamp;
+   BlockRamp rateRamp{ BlockRamp::Type::multiplicative };
+
+   void renderLfo(float* dest, int numSamples);
+   void followCutoffRamp(int numSamples);
+   void requestLowPassDesign();
+
+   LowPassDesigner lowPassDesigner;
+
+   // What the pipeline's stages apply to the current chunk, see renderNodeControl()
+   NodeControl nodeControl;
+
+   // The pipeline that processes audio, once per sample precision: tremolo
+   // (only ahead of the filter), low-pass, then tremolo and output gain fused.
+   // Both are prepared and kept in step; processBlock only runs the one it is given.
+   template <typename SampleType>
+   struct SignalPath
    {
-       HighCut
+       explicit SignalPath(const NodeControl& control)
+           : pipeline(control, control, control)
+       {
+       }
+
+       StaticPipeline<SampleType, TremoloNode<SampleType>, LowPassNode<SampleType>, AmplitudeNode<SampleType>> pipeline;
+
+       LowPassNode<SampleType>& lowPass{ pipeline.template get<LowPassNode<SampleType>>() };
    };
 
+   SignalPath<float> floatPath{ nodeControl };
+   SignalPath<double> doublePath{ nodeControl };
+
+   template <typename SampleType>
+   SignalPath<SampleType>& getPath() noexcept
+   {
+       if constexpr (std::is_same_v<SampleType, double>)
+           return doublePath;
+       else
+           return floatPath;
+   }
+
+   template <typename Callback>
+   void forEachPath(Callback&& callback)
+   {
+       callback(floatPath);
+       callback(doublePath);
+   }
+
+   void updateLowPassFilter(const CascadeCoefficients& coefficients);
+   void setLowPassSlope(int slope);
+
+   static constexpr float sweepOctaves = 6.0f;
+
+   bool sweepActive = false;
+
+   // Turns the chunk's modulation into nodeControl, in place in the matrix outputs
+   void renderNodeControl(int numSamples, bool filterActive);
+   float* renderCutoffSweep(float* cutoffModulation, int numSamples);
+   const float* renderOutputGain(float* gainModulation, float* phaseModulation, int numSamples);
+
+   // Factory programs with their filter coefficients designed up front
+   ProgramBank programBank;
+
+   std::atomic<int> currentProgram{ 0 };
+
+   // A program change the audio thread has applied, for the timer to show in the parameters
+   std::atomic<int> programToPublish{ -1 };
+
+   void applyProgram(int index);
+   void setParametersFromProgram(int index);
+   void timerCallback() override;
+
+   // The timer publishes programToPublish and writes the load log. It only
+   // runs between prepareToPlay and releaseResources, or while logging.
+   bool prepared = false;
+   void updateTimer();
+
+   LoadMeter loadMeter;
+
+   // Numbers the instances of a session, to tell their log lines apart
+   const int instanceId;
+
+   // Shared with any other instance logging to the same file
+   std::shared_ptr<juce::FileOutputStream> loadLog;
+   juce::uint32 lastLoggedWindow = 0;
+
+   void writeLoadLog();
+
     // return std::sin (x); //Sine Wave
     // return x / MathConstants<float>::pi // Saw Wave
     // return x < 0.0f ? -1.0f : 1.0f; // Square Wave
@@ -0,0 +1,111 @@
+#ifndef PluginState_hpp
+#define PluginState_hpp
+
+//==============================================================================
+// Session state as a compact, versioned binary block: a magic number, the
+// format version, the current program (from version 2), a parameter count,
+// then each parameter's ID and real value.
+// Restoring looks each ID up directly and only sets parameters whose value
+// actually differs. It never rebuilds the ValueTree, so reloading a project
+// with hundreds of instances costs little more than reading the bytes, and
+// unchanged values don't reach the audio thread as changes at all.
+//
+// IDs the layout no longer has are skipped and missing ones keep their
+// defaults. State written as XML by copyXmlToBinary is still read; it and
+// version 1 have no program, which is then left as it is.
+
+namespace PluginState
+{
+	constexpr int magic = 0x5343534f; // "OSCS"
+	constexpr int version = 2;
+
+	inline void setIfChanged (juce::RangedAudioParameter& param, float value)
+	{
+		auto normalised = param.convertTo0to1 (value);
+
+		// Saved values don't always survive the range conversion bit for bit
+		if (std::abs (param.getValue() - normalised) > 1.0e-7f)
+			param.setValueNotifyingHost (normalised);
+	}
+
+	inline void write (juce::AudioProcessorValueTreeState& apvts, int program, juce::MemoryBlock& dest)
+	{
+		juce::Array<juce::RangedAudioParameter*> params;
+
+		for (auto* param : apvts.processor.getParameters())
+			if (auto* ranged = dynamic_cast<juce::RangedAudioParameter*> (param))
+				params.add (ranged);
+
+		juce::MemoryOutputStream stream (dest, false);
+		stream.writeInt (magic);
+		stream.writeInt (version);
+		stream.writeCompressedInt (program);
+		stream.writeCompressedInt (params.size());
+
+		for (auto* param : params)
+		{
+			stream.writeString (param->getParameterID());
+			stream.writeFloat (param->convertFrom0to1 (param->getValue()));
+		}
+	}
+
+	inline bool readBinary (juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes, int& program)
+	{
+		juce::MemoryInputStream stream (data, (size_t) sizeInBytes, false);
+
+		if (sizeInBytes < 8 || stream.readInt() != magic)
+			return false;
+
+		auto savedVersion = stream.readInt();
+
+		if (savedVersion > version)
+		{
+			jassertfalse; // saved by a newer build
+			return false;
+		}
+
+		if (savedVersion >= 2)
+			program = stream.readCompressedInt();
+
+		auto numParams = stream.readCompressedInt();
+
+		for (int i = 0; i < numParams && ! stream.isExhausted(); ++i)
+		{
+			auto id = stream.readString();
+
+			// A truncated last entry would read its value as 0, so it's dropped
+			if (stream.getNumBytesRemaining() < (juce::int64) sizeof (float))
+				break;
+
+			auto value = stream.readFloat();
+
+			if (auto* param = apvts.getParameter (id))
+				setIfChanged (*param, value);
+		}
+
+		return true;
+	}
+
+	inline bool readXml (juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes)
+	{
+		auto xml = juce::AudioProcessor::getXmlFromBinary (data, sizeInBytes);
+
+		if (xml == nullptr || ! xml->hasTagName (apvts.state.getType()))
+			return false;
+
+		for (auto* child : xml->getChildWithTagNameIterator ("PARAM"))
+			if (auto* param = apvts.getParameter (child->getStringAttribute ("id")))
+				setIfChanged (*param, (float) child->getDoubleAttribute ("value"));
+
+		return true;
+	}
+
+	// True if the data was recognised as either format. The parameters are
+	// restored; program only receives the saved index, if there is one.
+	inline bool read (juce::AudioProcessorValueTreeState& apvts, const void* data, int sizeInBytes, int& program)
+	{
+		return readBinary (apvts, data, sizeInBytes, program) || readXml (apvts, data, sizeInBytes);
+	}
+}
+
+#endif // PluginState.hpp
@@ -9,6 +9,14 @@ namespace MODID
 	PARAMETER_ID (GainPhase)
 }
 
+// The output gain parameters as read once per block
+struct GainSettings
+{
+	float gainDecibels = 0.f;
+	bool bypassed = false;
+	bool invertPhase = false;
+};
+
 //==============================================================================
 
 static juce::String valueToTextFunction (float x) { return juce::String (x, 1); }
@@ -50,9 +58,36 @@ static juce::String stringFromValueRatio (float value, int) {
 		return "1 : " + juce::String (value, 0);
 }
 
+//==============================================================================
+// Applies a float control signal, e.g. from the modulation matrix, to audio at
+// either precision. Modulation is always rendered in float.
+
+namespace SampleOps
+{
+	inline void multiply (float* data, const float* factors, int numSamples) noexcept
+	{
+		juce::FloatVectorOperations::multiply (data, factors, numSamples);
+	}
+
+	inline void multiply (double* data, const float* factors, int numSamples) noexcept
+	{
+		for (int i = 0; i < numSamples; ++i)
+			data[i] *= (double) factors[i];
+	}
+
+	// data *= factors * moreFactors in one pass
+	template <typename SampleType>
+	inline void multiply (SampleType* data, const SampleType* factors, const float* moreFactors, int numSamples) noexcept
+	{
+		for (int i = 0; i < numSamples; ++i)
+			data[i] *= factors[i] * (SampleType) moreFactors[i];
+	}
+}
+
 //==============================================================================
 
 
+template <typename SampleType = float>
 class ProcessorBase
 {
 public:
@@ -69,10 +104,6 @@ public:
 	
 	virtual void addParams(juce::AudioProcessorParameterGroup&) = 0;
 
-	virtual bool update(juce::AudioProcessorValueTreeState&) = 0;
-	
-	virtual void process (juce::dsp::ProcessContextReplacing<float>&) = 0;
-
 private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessorBase)
@@ -80,65 +111,54 @@ private:
 
 
 //==============================================================================
-class GainProcessor : public ProcessorBase
+// Compile-time counterpart of ProcessorBase for the stages of a StaticPipeline.
+// The pipeline holds every stage by value and calls it through its own type,
+// so there are no virtual calls and each stage inlines into the chunk loop.
+// Derived provides process() and hides whichever hooks it needs.
+
+template <typename Derived, typename SampleType = float>
+class StaticProcessorBase
 {
 public:
-	GainProcessor()
-	{
-		gain.setGainDecibels (-6.0f);
-	}
-	
-	virtual ~GainProcessor() { }
-	
-	const juce::String getName() const override { return "Gain"; }
+	void prepare (const juce::dsp::ProcessSpec&) {}
 
-	void addParams(juce::AudioProcessorParameterGroup& params) override
-	{
-		params.addChild(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(MODID::GainBypass, 1), "Gain Bypass", false));
-		params.addChild(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(MODID::GainPhase, 1), "Phase", false));
-		params.addChild(std::make_unique<juce::AudioProcessorValueTreeState::Parameter> (juce::ParameterID(MODID::Gain, 1), "Gain", " dB", juce::NormalisableRange<float> (-24.0, 24.0), 0.0, valueToTextFunction, textToValueFunction));
-	}
-	
-	bool update(juce::AudioProcessorValueTreeState& parameters) override
-	{
-		bool byp = (bool)parameters.getRawParameterValue(MODID::GainBypass)->load();
-		float g = juce::Decibels::decibelsToGain(parameters.getRawParameterValue(MODID::Gain)->load());
-		int phase = parameters.getRawParameterValue(MODID::GainPhase)->load();
-		if (phase)
-			g *= -1.f;
-		setGain(byp? 1.f : g);
-		
-		return byp;
-	}
+	void reset() {}
 
-	void prepare (const juce::dsp::ProcessSpec& spec) override
-	{
-		gain.prepare (spec);
-	}
-	
-	void setdBGain(float g) 
-	{
-		gain.setGainDecibels(g);
-	}
-	
-	void setGain(float g) 
-	{
-		gain.setGainLinear(g);
-	}
+	// True if the stage should be skipped this block. Parameters is whatever
+	// the pipeline's owner passes to StaticPipeline::update().
+	template <typename Parameters>
+	bool update (const Parameters&) { return false; }
 
-	void process (juce::dsp::ProcessContextReplacing<float>& context) override
-	{		
-		gain.process (context);
-	}
-
-	void reset() override
+	void processUnlessBypassed (juce::dsp::ProcessContextReplacing<SampleType>& context, bool bypassed)
 	{
-		gain.reset();
+		if (! bypassed)
+			static_cast<Derived&> (*this).process (context);
 	}
 
+protected:
+	StaticProcessorBase() = default;
+	~StaticProcessorBase() = default;
 
-private:
-	juce::dsp::Gain<float> gain;
+	JUCE_DECLARE_NON_COPYABLE (StaticProcessorBase)
 };
 
+//==============================================================================
+// The output gain and polarity, applied by the pipeline's AmplitudeNode
+
+inline void addGainParams (juce::AudioProcessorParameterGroup& params)
+{
+	params.addChild(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(MODID::GainBypass, 1), "Gain Bypass", false));
+	params.addChild(std::make_unique<juce::AudioParameterBool> (juce::ParameterID(MODID::GainPhase, 1), "Phase", false));
+	params.addChild(std::make_unique<juce::AudioProcessorValueTreeState::Parameter> (juce::ParameterID(MODID::Gain, 1), "Gain", " dB", juce::NormalisableRange<float> (-24.0, 24.0), 0.0, valueToTextFunction, textToValueFunction));
+}
+
+// Linear gain with the polarity applied, or unity while bypassed
+inline float getTargetGain (const GainSettings& settings)
+{
+	float g = juce::Decibels::decibelsToGain(settings.gainDecibels);
+	if (settings.invertPhase)
+		g *= -1.f;
+	return settings.bypassed ? 1.f : g;
+}
+
 #endif // ProcessorBase.hpp
@@ -0,0 +1,108 @@
+#ifndef ProgramBank_hpp
+#define ProgramBank_hpp
+
+#include "FilterDesigner.hpp"
+#include "Lfo.hpp"
+
+//==============================================================================
+// Factory tremolo and filter presets. Indices follow the parameter choices:
+// Modulation 0 Volume / 1 LowPass, NoteVal 0 "2" ... 6 "1/32", Feel
+// Straight / Dotted / Triplet, slope 0..3 for 12..48 dB/Oct.
+
+struct ProgramPreset
+{
+	const char* name;
+	int modulation;
+	bool inSync;
+	int noteIndex;
+	int feelIndex;
+	int waveIndex;
+	float rate;
+	float depth;
+	float lowPassFreq;
+	int lowPassSlope;
+};
+
+inline constexpr ProgramPreset FactoryPrograms[] =
+{
+	//  name				mod	sync	note	feel	wave		rate	depth	lowpass		slope
+	{ "Init",				0,	true,	0,		0,		SINE,		5.0f,	0.5f,	20000.f,	0 },
+	{ "Gentle Tremolo",		0,	true,	3,		0,		SINE,		5.0f,	0.3f,	20000.f,	0 },
+	{ "Choppy Eighths",		0,	true,	4,		0,		SQUARE,		5.0f,	0.8f,	20000.f,	0 },
+	{ "Triplet Pulse",		0,	true,	4,		2,		TRIANGLE,	5.0f,	0.6f,	20000.f,	0 },
+	{ "Slow Swell",			0,	false,	0,		0,		SINE,		0.5f,	0.5f,	20000.f,	0 },
+	{ "Filter Wah",			1,	true,	3,		0,		SINE,		5.0f,	0.7f,	8000.f,		1 },
+	{ "Dark Sweep",			1,	true,	1,		0,		TRIANGLE,	5.0f,	0.9f,	4000.f,		3 },
+	{ "Saw Filter Chop",	1,	true,	5,		0,		SAWTOOTH,	5.0f,	0.6f,	12000.f,	2 },
+	{ "Static Low-Pass",	1,	false,	0,		0,		SINE,		1.0f,	0.0f,	2000.f,		1 },
+};
+
+//==============================================================================
+// The factory programs together with their derived DSP state: the low-pass
+// cascade for each program's cutoff and slope, and its cutoff in octaves,
+// computed for the current sample rate in prepare(). During playback the
+// prepared state is read-only, so the audio thread can swap a whole program
+// in at a block boundary with no filter design and no allocation.
+//
+// A program change is handed to the audio thread through request(), which
+// any thread may call, and picked up once per block with pullRequest().
+
+class ProgramBank
+{
+public:
+	static constexpr int numPrograms = (int) std::size (FactoryPrograms);
+
+	struct PreparedState
+	{
+		CascadeCoefficients lowPass;
+		float cutoffOctave = 0.f;
+	};
+
+	static const ProgramPreset& getProgram (int index) noexcept
+	{
+		return FactoryPrograms[juce::jlimit (0, numPrograms - 1, index)];
+	}
+
+	// Must be called while the audio thread is stopped, e.g. from prepareToPlay
+	void prepare (double sampleRate)
+	{
+		if (sampleRate == preparedSampleRate)
+			return;
+
+		preparedSampleRate = sampleRate;
+
+		for (int i = 0; i < numPrograms; ++i)
+		{
+			auto& program = FactoryPrograms[i];
+			auto& state = prepared[(size_t) i];
+
+			LowPassDesigner::design (sampleRate, program.lowPassFreq, program.lowPassSlope, state.lowPass);
+			state.cutoffOctave = std::log2 (program.lowPassFreq);
+		}
+	}
+
+	const PreparedState& getPreparedState (int index) const noexcept
+	{
+		return prepared[(size_t) juce::jlimit (0, numPrograms - 1, index)];
+	}
+
+	void request (int index) noexcept
+	{
+		if (juce::isPositiveAndBelow (index, numPrograms))
+			pending.store (index, std::memory_order_release);
+	}
+
+	// Audio thread. The most recently requested program, or -1 if none is waiting.
+	int pullRequest() noexcept
+	{
+		return pending.exchange (-1, std::memory_order_acquire);
+	}
+
+private:
+	std::array<PreparedState, (size_t) numPrograms> prepared {};
+	double preparedSampleRate = 0.0;
+
+	std::atomic<int> pending { -1 };
+};
+
+#endif // ProgramBank.hpp
@@ -0,0 +1,222 @@
+#ifndef SignalNodes_hpp
+#define SignalNodes_hpp
+
+#include "ProcessorBase.hpp"
+#include "BiquadCascade.hpp"
+#include "SvfLowPass.hpp"
+
+//==============================================================================
+// Control signals for one chunk, rendered in float by the processor before
+// the pipeline runs. Each pointer holds one value per sample of the chunk, or
+// is nullptr when that stage has nothing to apply.
+
+struct NodeControl
+{
+	const float* tremoloGain = nullptr;		// 1 - summed Volume modulation
+	const float* const* channelTremoloGains = nullptr;	// one tremoloGain per channel instead, while LFO 1 is spread
+	bool tremoloBeforeFilter = false;		// set while the filter runs, see AmplitudeNode
+	bool filterActive = false;
+	float* cutoffOctaves = nullptr;			// swept cutoff; nullptr runs the static biquads
+	const float* outputGain = nullptr;		// Gain and Phase modulation combined
+
+	bool hasTremolo() const noexcept { return tremoloGain != nullptr || channelTremoloGains != nullptr; }
+
+	const float* getTremoloGain (size_t channel) const noexcept
+	{
+		return channelTremoloGains != nullptr ? channelTremoloGains[channel] : tremoloGain;
+	}
+};
+
+//==============================================================================
+// The stages the processor's pipeline is built from, in processing order.
+// Their parameters are read by the processor's ParameterSnapshot; the output
+// gain's reach AmplitudeNode through the pipeline's update().
+
+// The tremolo on its own, only needed while the low-pass runs after it.
+// Otherwise AmplitudeNode applies it together with the output gain.
+template <typename SampleType>
+class TremoloNode : public StaticProcessorBase<TremoloNode<SampleType>, SampleType>
+{
+public:
+	explicit TremoloNode (const NodeControl& controlToUse) : control (controlToUse) {}
+
+	void process (juce::dsp::ProcessContextReplacing<SampleType>& context)
+	{
+		if (! control.tremoloBeforeFilter || ! control.hasTremolo())
+			return;
+
+		auto& block = context.getOutputBlock();
+
+		for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+			SampleOps::multiply (block.getChannelPointer (ch), control.getTremoloGain (ch), (int) block.getNumSamples());
+	}
+
+private:
+	const NodeControl& control;
+};
+
+//==============================================================================
+// The Butterworth biquads for a static cutoff, or the state variable filter
+// while the cutoff is swept.
+
+template <typename SampleType>
+class LowPassNode : public StaticProcessorBase<LowPassNode<SampleType>, SampleType>
+{
+public:
+	explicit LowPassNode (const NodeControl& controlToUse) : control (controlToUse) {}
+
+	void prepare (const juce::dsp::ProcessSpec& spec)
+	{
+		biquads.prepare ((int) spec.numChannels, (int) spec.maximumBlockSize);
+		sweep.prepare (spec.sampleRate, (int) spec.numChannels, (int) spec.maximumBlockSize);
+	}
+
+	void reset()
+	{
+		biquads.reset();
+		sweep.reset();
+	}
+
+	void setCoefficients (const CascadeCoefficients& coefficients) noexcept	{ biquads.setCoefficients (coefficients); }
+	void setSlope (int slope) noexcept										{ sweep.setSlope (slope); }
+
+	// Called when the filter switches between the two, so neither resumes from stale state
+	void resetBiquads() noexcept	{ biquads.reset(); }
+	void resetSweep() noexcept		{ sweep.reset(); }
+
+	void process (juce::dsp::ProcessContextReplacing<SampleType>& context)
+	{
+		if (! control.filterActive)
+			return;
+
+		auto& block = context.getOutputBlock();
+
+		if (control.cutoffOctaves != nullptr)
+			sweep.process (block, control.cutoffOctaves);
+		else
+			biquads.process (block);
+	}
+
+private:
+	const NodeControl& control;
+
+	// Both channels share coefficients, so they are filtered together in SIMD lanes
+	LinkedLowPass<SampleType> biquads;
+
+	// LFO-swept low-pass, used instead of the biquads whenever the cutoff is modulated
+	SvfLowPass<SampleType> sweep;
+};
+
+//==============================================================================
+// Tremolo, output gain and polarity (see addGainParams) and the
+// Gain and Phase routes, fused. Everything that scales the signal is first
+// multiplied into one factor per sample, then each channel is scaled by it in
+// a single pass. With nothing modulated and the gain settled, that pass is a
+// constant multiply, or nothing at all at unity. A tremolo that differs per
+// channel is multiplied in during that same pass instead.
+
+template <typename SampleType>
+class AmplitudeNode : public StaticProcessorBase<AmplitudeNode<SampleType>, SampleType>
+{
+public:
+	static constexpr double gainRampSeconds = 0.02;
+
+	explicit AmplitudeNode (const NodeControl& controlToUse) : control (controlToUse) {}
+
+	void prepare (const juce::dsp::ProcessSpec& spec)
+	{
+		gain.reset (spec.sampleRate, gainRampSeconds);
+		factors.resize ((size_t) juce::jmax (1u, spec.maximumBlockSize));
+		jumpToTarget = true;
+	}
+
+	void reset()
+	{
+		gain.setCurrentAndTargetValue (gain.getTargetValue());
+	}
+
+	// Never bypassed as a whole: with the gain bypassed the tremolo still applies
+	bool update (const GainSettings& settings)
+	{
+		gainBypassed = settings.bypassed;
+
+		if (std::exchange (jumpToTarget, false))
+			gain.setCurrentAndTargetValue ((SampleType) getTargetGain (settings));
+		else
+			gain.setTargetValue ((SampleType) getTargetGain (settings));
+
+		return false;
+	}
+
+	void process (juce::dsp::ProcessContextReplacing<SampleType>& context)
+	{
+		auto& block = context.getOutputBlock();
+		auto numSamples = (int) block.getNumSamples();
+
+		auto* tremolo = control.tremoloBeforeFilter ? nullptr : control.tremoloGain;
+		auto* channelTremolo = control.tremoloBeforeFilter ? nullptr : control.channelTremoloGains;
+		auto* modulation = gainBypassed ? nullptr : control.outputGain;
+
+		if (tremolo == nullptr && channelTremolo == nullptr && modulation == nullptr && ! gain.isSmoothing())
+		{
+			auto g = gain.getTargetValue();
+
+			if (g != SampleType (1))
+				for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+					juce::FloatVectorOperations::multiply (block.getChannelPointer (ch), g, numSamples);
+
+			return;
+		}
+
+		jassert (numSamples <= (int) factors.size());
+		numSamples = juce::jmin (numSamples, (int) factors.size());
+
+		auto* factor = factors.data();
+
+		if (tremolo != nullptr && modulation != nullptr)	renderFactors<true, true> (factor, tremolo, modulation, numSamples);
+		else if (tremolo != nullptr)						renderFactors<true, false> (factor, tremolo, modulation, numSamples);
+		else if (modulation != nullptr)						renderFactors<false, true> (factor, tremolo, modulation, numSamples);
+		else												renderFactors<false, false> (factor, tremolo, modulation, numSamples);
+
+		if (channelTremolo != nullptr)
+		{
+			for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+				SampleOps::multiply (block.getChannelPointer (ch), factor, channelTremolo[ch], numSamples);
+
+			return;
+		}
+
+		for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+			juce::FloatVectorOperations::multiply (block.getChannelPointer (ch), factor, numSamples);
+	}
+
+private:
+	template <bool WithTremolo, bool WithModulation>
+	void renderFactors (SampleType* dest, const float* tremolo, const float* modulation, int numSamples) noexcept
+	{
+		for (int i = 0; i < numSamples; ++i)
+		{
+			auto g = gain.getNextValue();
+
+			if constexpr (WithTremolo)
+				g *= (SampleType) tremolo[i];
+
+			if constexpr (WithModulation)
+				g *= (SampleType) modulation[i];
+
+			dest[i] = g;
+		}
+	}
+
+	const NodeControl& control;
+
+	juce::SmoothedValue<SampleType> gain { SampleType (1) };
+	bool gainBypassed = false;
+
+	// Set by prepare(), so a render starts at the saved gain rather than ramping to it
+	bool jumpToTarget = true;
+
+	std::vector<SampleType> factors;
+};
+
+#endif // SignalNodes.hpp
@@ -0,0 +1,64 @@
+#ifndef SpscFifo_hpp
+#define SpscFifo_hpp
+
+//==============================================================================
+// Wait-free single-producer/single-consumer ring buffer of fixed capacity.
+// push() and pop() each touch one slot and two atomic counters, never block
+// and never allocate. A push into a full FIFO is refused rather than
+// overwriting, so the reader never sees a slot while it is being written.
+
+template <typename ValueType, int Capacity>
+class SpscFifo
+{
+public:
+	static_assert (Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+	SpscFifo() = default;
+
+	//==============================================================================
+	// Producer. False if the FIFO is full and the value was dropped.
+	bool push (const ValueType& value) noexcept
+	{
+		auto write = writePosition.load (std::memory_order_relaxed);
+
+		if (write - readPosition.load (std::memory_order_acquire) == (juce::uint32) Capacity)
+			return false;
+
+		items[(size_t) (write & mask)] = value;
+		writePosition.store (write + 1, std::memory_order_release);
+		return true;
+	}
+
+	//==============================================================================
+	// Consumer. False if there was nothing to read.
+	bool pop (ValueType& value) noexcept
+	{
+		auto read = readPosition.load (std::memory_order_relaxed);
+
+		if (read == writePosition.load (std::memory_order_acquire))
+			return false;
+
+		value = items[(size_t) (read & mask)];
+		readPosition.store (read + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer. Drops everything written so far.
+	void discardAll() noexcept
+	{
+		readPosition.store (writePosition.load (std::memory_order_acquire), std::memory_order_release);
+	}
+
+private:
+	static constexpr juce::uint32 mask = (juce::uint32) Capacity - 1;
+
+	std::array<ValueType, (size_t) Capacity> items {};
+
+	// Kept on separate cache lines so the two threads don't contend
+	alignas (64) std::atomic<juce::uint32> writePosition { 0 };
+	alignas (64) std::atomic<juce::uint32> readPosition { 0 };
+
+	JUCE_DECLARE_NON_COPYABLE (SpscFifo)
+};
+
+#endif // SpscFifo.hpp
@@ -0,0 +1,71 @@
+#ifndef StaticPipeline_hpp
+#define StaticPipeline_hpp
+
+#include "ProcessorBase.hpp"
+
+//==============================================================================
+// A chain of StaticProcessorBase stages fixed at compile time. The stages are
+// held by value in a tuple and every call is expanded over them, so the whole
+// chain resolves to direct calls with no vtable. Each stage processes the
+// block in place, and a stage whose update() reports it as bypassed is
+// skipped without touching the audio.
+
+template <typename SampleType, typename... Stages>
+class StaticPipeline
+{
+public:
+	static constexpr size_t numStages = sizeof... (Stages);
+
+	// One constructor argument per stage, in order
+	template <typename... Args>
+	explicit StaticPipeline (Args&&... args) : stages (std::forward<Args> (args)...) {}
+
+	template <typename Stage>
+	Stage& get() noexcept { return std::get<Stage> (stages); }
+
+	// Must be called while the audio thread is stopped, e.g. from prepareToPlay
+	void prepare (const juce::dsp::ProcessSpec& spec)
+	{
+		std::apply ([&] (auto&... stage) { (stage.prepare (spec), ...); }, stages);
+		bypassed.fill (false);
+	}
+
+	void reset()
+	{
+		std::apply ([] (auto&... stage) { (stage.reset(), ...); }, stages);
+	}
+
+	// Audio thread, once per block. Hands every stage the same parameters,
+	// already read by the owner; stages that need none ignore them.
+	template <typename Parameters>
+	void update (const Parameters& parameters)
+	{
+		update (parameters, std::index_sequence_for<Stages...> {});
+	}
+
+	void process (juce::dsp::ProcessContextReplacing<SampleType>& context)
+	{
+		if (! context.isBypassed)
+			process (context, std::index_sequence_for<Stages...> {});
+	}
+
+private:
+	template <typename Parameters, size_t... Index>
+	void update (const Parameters& parameters, std::index_sequence<Index...>)
+	{
+		((bypassed[Index] = std::get<Index> (stages).update (parameters)), ...);
+	}
+
+	template <size_t... Index>
+	void process (juce::dsp::ProcessContextReplacing<SampleType>& context, std::index_sequence<Index...>)
+	{
+		(std::get<Index> (stages).processUnlessBypassed (context, bypassed[Index]), ...);
+	}
+
+	std::tuple<Stages...> stages;
+	std::array<bool, numStages> bypassed {};
+
+	JUCE_DECLARE_NON_COPYABLE (StaticPipeline)
+};
+
+#endif // StaticPipeline.hpp
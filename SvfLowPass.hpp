@@ -0,0 +1,156 @@
+#ifndef SvfLowPass_hpp
+#define SvfLowPass_hpp
+
+#include "ButterworthTable.hpp"
+#include "ChannelGroups.hpp"
+
+//==============================================================================
+// Modulated low-pass built on the topology-preserving state variable filter
+// used by juce::dsp::StateVariableTPTFilter. Unlike the biquad cascade it stays
+// stable and artefact-free when the cutoff moves while it runs, so the LFO can
+// drive it directly. The cutoff is read every controlInterval samples and its
+// coefficients come from a ButterworthTable, and slopes above 12 dB/oct
+// cascade sections with Butterworth damping so the response matches the
+// static filter. Coefficients are looked up in float; the filter state and
+// the audio run at SampleType, with the channels filtered in ChannelGroups.
+
+template <typename SampleType>
+class SvfLowPass
+{
+public:
+	static constexpr int maxStages = CascadeCoefficients::maxStages;
+	static constexpr int controlInterval = 16;
+
+	using Vector = typename ChannelGroups<SampleType>::Vector;
+
+	void prepare (double newSampleRate, int maxChannels, int maxBlockSize)
+	{
+		table.build (newSampleRate);
+
+		state.resize ((size_t) ChannelGroups<SampleType>::getNumGroups (maxChannels));
+		channels.prepare (maxBlockSize);
+
+		auto maxSubBlocks = (size_t) ((juce::jmax (1, maxBlockSize) + controlInterval - 1) / controlInterval);
+		subBlockG.resize (maxSubBlocks);
+		subBlockH.resize (maxSubBlocks);
+
+		reset();
+	}
+
+	void reset() noexcept
+	{
+		for (auto& group : state)
+			group = {};
+	}
+
+	void setSlope (int slope) noexcept
+	{
+		auto stages = juce::jlimit (1, maxStages, slope + 1);
+
+		if (stages == numStages)
+			return;
+
+		numStages = stages;
+
+		for (int i = 0; i < numStages; ++i)
+			damping[(size_t) i] = ButterworthTable::getDamping (numStages, i);
+
+		reset();
+	}
+
+	// cutoffOctaves holds log2 (cutoff in Hz) per sample; only every
+	// controlInterval-th value is used
+	void process (juce::dsp::AudioBlock<SampleType>& block, const float* cutoffOctaves) noexcept
+	{
+		auto numSamples = (int) block.getNumSamples();
+
+		jassert (numSamples <= (int) subBlockG.size() * controlInterval);
+
+		updateCoefficients (cutoffOctaves, numSamples);
+
+		switch (numStages)
+		{
+			case 1:	processStages<1> (block); break;
+			case 2:	processStages<2> (block); break;
+			case 3:	processStages<3> (block); break;
+			case 4:	processStages<4> (block); break;
+			default: break;
+		}
+	}
+
+private:
+	void updateCoefficients (const float* cutoffOctaves, int numSamples) noexcept
+	{
+		if (numStages == 0)
+			return;
+
+		for (int start = 0, k = 0; start < numSamples; start += controlInterval, ++k)
+		{
+			auto coefficients = table.lookup (numStages, cutoffOctaves[start]);
+
+			subBlockG[(size_t) k] = coefficients.g;
+			subBlockH[(size_t) k] = coefficients.h;
+		}
+	}
+
+	template <int NumStages>
+	void processStages (juce::dsp::AudioBlock<SampleType>& block) noexcept
+	{
+		channels.process (block, (int) state.size(), [this] (int group, Vector* data, int start, int numSamples)
+		{
+			auto s = state[(size_t) group];
+
+			for (int n = 0; n < numSamples;)
+			{
+				auto k = (size_t) ((start + n) / controlInterval);
+				auto end = juce::jmin (numSamples, (int) (k + 1) * controlInterval - start);
+
+				auto g = Vector::expand ((SampleType) subBlockG[k]);
+				std::array<Vector, NumStages> h, gPlusDamping;
+
+				for (size_t i = 0; i < NumStages; ++i)
+				{
+					h[i] = Vector::expand ((SampleType) subBlockH[k][i]);
+					gPlusDamping[i] = Vector::expand ((SampleType) subBlockG[k] + (SampleType) damping[i]);
+				}
+
+				for (; n < end; ++n)
+				{
+					auto x = data[n];
+
+					for (size_t i = 0; i < NumStages; ++i)
+					{
+						auto yHP = h[i] * (x - s[i][0] * gPlusDamping[i] - s[i][1]);
+
+						auto yBP = yHP * g + s[i][0];
+						s[i][0] = yHP * g + yBP;
+
+						auto yLP = yBP * g + s[i][1];
+						s[i][1] = yBP * g + yLP;
+
+						x = yLP;
+					}
+
+					data[n] = x;
+				}
+			}
+
+			// Denormals are left to the ScopedNoDenormals in processBlock, as for the biquads
+			state[(size_t) group] = s;
+		});
+	}
+
+	// One register per group of channels, per stage
+	using StageState = std::array<std::array<Vector, 2>, maxStages>;
+
+	ButterworthTable table;
+	int numStages = 0;
+	std::array<float, maxStages> damping {};
+
+	std::vector<StageState> state;
+	ChannelGroups<SampleType> channels;
+	std::vector<float> subBlockG;
+	std::vector<std::array<float, maxStages>> subBlockH;
+};
+
+#endif // SvfLowPass.hpp
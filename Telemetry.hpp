@@ -0,0 +1,122 @@
+#ifndef Telemetry_hpp
+#define Telemetry_hpp
+
+#include "SpscFifo.hpp"
+
+//==============================================================================
+// Feeds the editor's scopes from the audio thread. Each block is reduced to
+// framesPerSecond frames holding LFO 1, the summed modulation and the output's
+// min and max over the frame, which are pushed into an SpscFifo for the
+// message thread to drain.
+//
+// Nothing is captured unless an editor has called setEnabled (true), so a
+// closed editor costs the audio thread one atomic load per block.
+
+class Telemetry
+{
+public:
+	struct Frame
+	{
+		float lfo = 0.f;
+		float modulation = 0.f;
+		float outputMin = 0.f;
+		float outputMax = 0.f;
+	};
+
+	static constexpr double framesPerSecond = 500.0;
+
+	// Room for about two seconds of frames, plenty for a consumer at any frame rate
+	static constexpr int fifoSize = 1024;
+
+	// Must be called while the audio thread is stopped, e.g. from prepareToPlay
+	void prepare (double sampleRate, int maxBlockSize)
+	{
+		decimation = juce::jmax (1, juce::roundToInt (sampleRate / framesPerSecond));
+		pending.resize ((size_t) (juce::jmax (1, maxBlockSize) / decimation + 1));
+		numPending = 0;
+		samplesInFrame = 0;
+		resetRange();
+	}
+
+	//==============================================================================
+	// Message thread
+	void setEnabled (bool shouldBeEnabled) noexcept		{ enabled.store (shouldBeEnabled, std::memory_order_release); }
+	bool pop (Frame& frame) noexcept					{ return fifo.pop (frame); }
+	void discardAll() noexcept							{ fifo.discardAll(); }
+
+	//==============================================================================
+	// Audio thread. Read once per block and skip both captures if false.
+	bool isEnabled() const noexcept						{ return enabled.load (std::memory_order_acquire); }
+
+	// Records the control values at the samples that will close a frame. Call
+	// before the block's modulation is applied; either pointer may be nullptr.
+	void captureControl (const float* lfo, const float* modulation, int numSamples) noexcept
+	{
+		numPending = 0;
+
+		for (int i = decimation - 1 - samplesInFrame; i < numSamples && numPending < (int) pending.size(); i += decimation)
+		{
+			pending[(size_t) numPending++] = { lfo != nullptr ? lfo[i] : 0.f,
+											   modulation != nullptr ? modulation[i] : 0.f };
+		}
+	}
+
+	// Tracks the processed block's range and pushes a frame for every one it completes
+	template <typename SampleType>
+	void captureOutput (const juce::dsp::AudioBlock<SampleType>& block) noexcept
+	{
+		auto numSamples = (int) block.getNumSamples();
+		int frame = 0;
+
+		for (int start = 0; start < numSamples;)
+		{
+			auto num = juce::jmin (decimation - samplesInFrame, numSamples - start);
+
+			for (size_t ch = 0; ch < block.getNumChannels(); ++ch)
+			{
+				auto range = juce::FloatVectorOperations::findMinAndMax (block.getChannelPointer (ch) + start, num);
+				outputMin = juce::jmin (outputMin, (float) range.getStart());
+				outputMax = juce::jmax (outputMax, (float) range.getEnd());
+			}
+
+			start += num;
+			samplesInFrame += num;
+
+			if (samplesInFrame == decimation)
+			{
+				auto control = frame < numPending ? pending[(size_t) frame++] : Control {};
+
+				// Dropped if the editor has stopped reading
+				fifo.push ({ control.lfo, control.modulation, outputMin, outputMax });
+
+				samplesInFrame = 0;
+				resetRange();
+			}
+		}
+	}
+
+private:
+	struct Control
+	{
+		float lfo = 0.f;
+		float modulation = 0.f;
+	};
+
+	void resetRange() noexcept
+	{
+		outputMin = std::numeric_limits<float>::max();
+		outputMax = std::numeric_limits<float>::lowest();
+	}
+
+	std::atomic<bool> enabled { false };
+	SpscFifo<Frame, fifoSize> fifo;
+
+	int decimation = 1;
+	int samplesInFrame = 0;
+	float outputMin = 0.f, outputMax = 0.f;
+
+	std::vector<Control> pending;
+	int numPending = 0;
+};
+
+#endif // Telemetry.hpp
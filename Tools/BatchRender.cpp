@@ -0,0 +1,361 @@
+/*
+  ==============================================================================
+
+    Offline batch renderer for BasicOscillatorAudioProcessor.
+
+    Build as a JUCE console application from this file plus PluginProcessor.cpp
+    and PluginEditor.cpp, like the benchmark.
+
+    Runs every WAV and AIFF file under the input folder through the plugin
+    and writes the result to the same relative path under the output folder,
+    in the same format, sample rate, channel count and bit depth. Files are
+    shared out to one worker thread per core, each with its own processor and
+    buffers, and each worker renders one file at a time from start to end.
+
+    Input is read straight from a memory-mapped file. Output goes through a
+    large FileOutputStream buffer, and samples are converted into a buffer
+    the worker allocates once, so nothing is allocated per block.
+
+    The preset is either a JSON object of parameter IDs and real values,
+    e.g. { "OscShape": 1, "rate": 2.5, "PhaseOffset": 180 }, or a state saved
+    by the plugin. Prints one JSON object per file and a summary with the
+    throughput as a multiple of real time, and exits with 1 if any file
+    failed.
+
+        OscBatchRender --input=stems --output=rendered [--preset=tremolo.json]
+                       [--threads=<cores>] [--block-size=1024]
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include "HeadlessHost.h"
+
+namespace
+{
+    constexpr int writeBufferBytes = 1 << 20;
+
+    struct FileResult
+    {
+        juce::String error;             // empty on success
+        int numChannels = 0;
+        double sampleRate = 0.0;
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;     // reading, processing and writing
+        double processSeconds = 0.0;    // processBlock alone
+    };
+
+    juce::String loadPreset(BasicOscillatorAudioProcessor& processor, const juce::File& file)
+    {
+        juce::MemoryBlock data;
+
+        if (! file.loadFileAsData(data))
+            return "Couldn't read preset " + file.getFullPathName();
+
+        auto json = juce::JSON::parse(data.toString());
+
+        // Anything that isn't a JSON object is taken to be a saved plugin state
+        if (auto* object = json.getDynamicObject())
+        {
+            for (auto& property : object->getProperties())
+            {
+                if (processor.apvts.getParameter(property.name.toString()) == nullptr)
+                    return "Unknown parameter " + property.name.toString() + " in " + file.getFileName();
+
+                HeadlessHost::setParameter(processor.apvts, property.name.toString(), (float) property.value);
+            }
+        }
+        else
+        {
+            processor.setStateInformation(data.getData(), (int) data.getSize());
+        }
+
+        return {};
+    }
+
+    //==============================================================================
+    /** Takes files from the shared list until there are none left. */
+    class Worker : public juce::Thread
+    {
+    public:
+        Worker(const juce::AudioFormatManager& formatsToUse, const juce::Array<juce::File>& filesToUse,
+               std::vector<FileResult>& resultsToUse, std::atomic<int>& nextFileToUse,
+               const juce::File& inputRootToUse, const juce::File& outputRootToUse, int blockSizeToUse)
+            : juce::Thread("Batch render worker"),
+              formats(formatsToUse), files(filesToUse), results(resultsToUse), nextFile(nextFileToUse),
+              inputRoot(inputRootToUse), outputRoot(outputRootToUse), blockSize(blockSizeToUse)
+        {
+            processor.setPlayHead(&playHead);
+
+            auto maxChannels = BasicOscillatorAudioProcessor::maxChannels;
+
+            buffer.setSize(maxChannels, blockSize);
+            fixedSamples.allocate((size_t) (maxChannels * blockSize), true);
+            fixedChannels.allocate((size_t) maxChannels + 1, true);
+        }
+
+        ~Worker() override
+        {
+            stopThread(-1);
+        }
+
+        BasicOscillatorAudioProcessor& getProcessor() noexcept { return processor; }
+
+        void run() override
+        {
+            for (auto index = nextFile++; index < files.size(); index = nextFile++)
+                results[(size_t) index] = render(files.getReference(index));
+        }
+
+    private:
+        FileResult render(const juce::File& input)
+        {
+            FileResult result;
+
+            auto* format = formats.findFormatForFileExtension(input.getFileExtension());
+            std::unique_ptr<juce::MemoryMappedAudioFormatReader> reader(format != nullptr ? format->createMemoryMappedReader(input) : nullptr);
+
+            if (reader == nullptr || ! reader->mapEntireFile())
+                return withError(result, "Couldn't map the file");
+
+            auto numChannels = (int) reader->numChannels;
+            auto sampleRate = reader->sampleRate;
+            auto length = reader->lengthInSamples;
+
+            if (numChannels < 1 || numChannels > BasicOscillatorAudioProcessor::maxChannels)
+                return withError(result, "Unsupported channel count " + juce::String(numChannels));
+
+            auto output = outputRoot.getChildFile(input.getRelativePathFrom(inputRoot));
+
+            if (output == input)
+                return withError(result, "Output would overwrite the input");
+
+            // FileOutputStream appends to an existing file
+            if (! output.getParentDirectory().createDirectory() || (output.exists() && ! output.deleteFile()))
+                return withError(result, "Couldn't replace " + output.getFullPathName());
+
+            auto stream = std::make_unique<juce::FileOutputStream>(output, writeBufferBytes);
+
+            if (stream->failedToOpen())
+                return withError(result, "Couldn't create " + output.getFullPathName());
+
+            std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate, (unsigned int) numChannels,
+                                                                                    (int) reader->bitsPerSample, reader->metadataValues, 0));
+
+            if (writer == nullptr)
+                return withError(result, "Couldn't write this format");
+
+            stream.release(); // now owned by the writer
+
+            processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+            processor.prepareToPlay(sampleRate, blockSize);
+            playHead.prepare(sampleRate);
+
+            for (int channel = 0; channel < numChannels; ++channel)
+                fixedChannels[channel] = fixedSamples + channel * blockSize;
+
+            fixedChannels[numChannels] = nullptr;
+
+            auto start = juce::Time::getHighResolutionTicks();
+            juce::int64 processTicks = 0;
+
+            for (juce::int64 position = 0; position < length; position += blockSize)
+            {
+                auto numSamples = (int) juce::jmin((juce::int64) blockSize, length - position);
+
+                // Only shrinks the view of the preallocated channels
+                buffer.setSize(numChannels, numSamples, false, false, true);
+                reader->read(buffer.getArrayOfWritePointers(), numChannels, position, numSamples);
+
+                auto processStart = juce::Time::getHighResolutionTicks();
+                processor.processBlock(buffer, midi);
+                processTicks += juce::Time::getHighResolutionTicks() - processStart;
+
+                playHead.advance(numSamples);
+
+                if (! write(*writer, numChannels, numSamples))
+                    return withError(result, "Write failed");
+            }
+
+            writer.reset(); // flushes the stream
+
+            processor.releaseResources();
+
+            result.numChannels = numChannels;
+            result.sampleRate = sampleRate;
+            result.audioSeconds = (double) length / sampleRate;
+            result.renderSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            result.processSeconds = juce::Time::highResolutionTicksToSeconds(processTicks);
+            return result;
+        }
+
+        // As AudioFormatWriter::writeFromFloatArrays, but into the worker's own
+        // buffer, as that allocates a scratch buffer on every call
+        bool write(juce::AudioFormatWriter& writer, int numChannels, int numSamples)
+        {
+            for (int channel = 0; channel < numChannels; ++channel)
+            {
+                auto* src = buffer.getReadPointer(channel);
+                auto* dest = fixedChannels[channel];
+
+                if (writer.isFloatingPoint())
+                    std::memcpy(dest, src, sizeof(float) * (size_t) numSamples);
+                else
+                    for (int i = 0; i < numSamples; ++i)
+                        dest[i] = (int) (juce::jlimit(-1.0f, 1.0f, src[i]) * (double) 0x7fffffff);
+            }
+
+            return writer.write(const_cast<const int**>(fixedChannels.get()), numSamples);
+        }
+
+        static FileResult withError(FileResult& result, const juce::String& error)
+        {
+            result.error = error;
+            return result;
+        }
+
+        const juce::AudioFormatManager& formats;
+        const juce::Array<juce::File>& files;
+        std::vector<FileResult>& results;
+        std::atomic<int>& nextFile;
+        juce::File inputRoot, outputRoot;
+        int blockSize;
+
+        BasicOscillatorAudioProcessor processor;
+        HeadlessHost::PlayHead playHead;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        juce::HeapBlock<int> fixedSamples;
+        juce::HeapBlock<int*> fixedChannels;    // null-terminated, as AudioFormatWriter::write expects
+
+        JUCE_DECLARE_NON_COPYABLE(Worker)
+    };
+
+    juce::String toJson(const juce::File& file, const FileResult& result)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("file", file.getFullPathName());
+
+        if (result.error.isNotEmpty())
+        {
+            object->setProperty("error", result.error);
+        }
+        else
+        {
+            object->setProperty("channels", result.numChannels);
+            object->setProperty("sample_rate", result.sampleRate);
+            object->setProperty("audio_seconds", result.audioSeconds);
+            object->setProperty("render_seconds", result.renderSeconds);
+            object->setProperty("realtime_multiple", result.audioSeconds / juce::jmax(1.0e-9, result.renderSeconds));
+            object->setProperty("process_realtime_multiple", result.audioSeconds / juce::jmax(1.0e-9, result.processSeconds));
+        }
+
+        return juce::JSON::toString(juce::var(object), true);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    if (! args.containsOption("--input") || ! args.containsOption("--output"))
+    {
+        std::cerr << "Usage: OscBatchRender --input=<folder> --output=<folder> [--preset=<file>] [--threads=<n>] [--block-size=<n>]" << std::endl;
+        return 1;
+    }
+
+    auto inputRoot = args.getFileForOption("--input");
+    auto outputRoot = args.getFileForOption("--output");
+
+    if (! inputRoot.isDirectory())
+    {
+        std::cerr << "No such folder " << inputRoot.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    auto blockSize = args.containsOption("--block-size")
+                   ? juce::jlimit(16, 65536, args.getValueForOption("--block-size").getIntValue())
+                   : 1024;
+
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    auto files = inputRoot.findChildFiles(juce::File::findFiles, true, "*.wav;*.aif;*.aiff");
+    files.sort();
+
+    if (files.isEmpty())
+    {
+        std::cerr << "No WAV or AIFF files in " << inputRoot.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    auto numThreads = args.containsOption("--threads")
+                    ? juce::jmax(1, args.getValueForOption("--threads").getIntValue())
+                    : juce::SystemStats::getNumCpus();
+
+    numThreads = juce::jmin(numThreads, files.size());
+
+    std::vector<FileResult> results((size_t) files.size());
+    std::atomic<int> nextFile { 0 };
+
+    // Processors are created and given the preset here on the message thread,
+    // then only used by their worker
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    for (int i = 0; i < numThreads; ++i)
+    {
+        workers.push_back(std::make_unique<Worker>(formats, files, results, nextFile, inputRoot, outputRoot, blockSize));
+
+        if (args.containsOption("--preset"))
+        {
+            auto error = loadPreset(workers.back()->getProcessor(), args.getFileForOption("--preset"));
+
+            if (error.isNotEmpty())
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    auto start = juce::Time::getHighResolutionTicks();
+
+    for (auto& worker : workers)
+        worker->startThread();
+
+    for (auto& worker : workers)
+        worker->waitForThreadToExit(-1);
+
+    auto wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+    int numFailed = 0;
+    double audioSeconds = 0.0;
+
+    for (int i = 0; i < files.size(); ++i)
+    {
+        auto& result = results[(size_t) i];
+
+        std::cout << toJson(files.getReference(i), result) << std::endl;
+
+        if (result.error.isNotEmpty())
+            ++numFailed;
+        else
+            audioSeconds += result.audioSeconds;
+    }
+
+    auto* summary = new juce::DynamicObject();
+    summary->setProperty("files", files.size());
+    summary->setProperty("failed", numFailed);
+    summary->setProperty("threads", numThreads);
+    summary->setProperty("block_size", blockSize);
+    summary->setProperty("audio_seconds", audioSeconds);
+    summary->setProperty("wall_seconds", wallSeconds);
+    summary->setProperty("realtime_multiple", audioSeconds / juce::jmax(1.0e-9, wallSeconds));
+    summary->setProperty("realtime_multiple_per_thread", audioSeconds / juce::jmax(1.0e-9, wallSeconds) / numThreads);
+
+    std::cout << juce::JSON::toString(juce::var(summary), true) << std::endl;
+
+    return numFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,199 @@
+/*
+  ==============================================================================
+
+    Headless benchmark for BasicOscillatorAudioProcessor.
+
+    Build as a JUCE console application from this file plus PluginProcessor.cpp
+    and PluginEditor.cpp, with the same modules and JucePlugin_* definitions as
+    the plugin. No editor is created.
+
+    Sweeps block size, sample rate, Modulation, InSync, OscShape and
+    LowPass Slope, and prints one JSON object per configuration. --double
+    runs the 64-bit processBlock instead of the 32-bit one, and --channels
+    sets the bus width, e.g. 12 for a 7.1.4 stem.
+
+        OscBenchmark [--seconds=1.0] [--double] [--channels=2] [--output=results.jsonl]
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include "HeadlessHost.h"
+
+namespace
+{
+    struct BenchmarkConfig
+    {
+        int numChannels;
+        int blockSize;
+        double sampleRate;
+        int modulation;
+        bool inSync;
+        int oscShape;
+        int slope;
+    };
+
+    struct BlockStats
+    {
+        double nsPerSample = 0.0;
+        double p50 = 0.0, p99 = 0.0, max = 0.0; // microseconds per block
+        double budgetFraction = 0.0;             // p99 block time / real-time block length
+    };
+
+    double percentile(std::vector<double>& sorted, double fraction)
+    {
+        auto index = (size_t) juce::jlimit(0.0, (double) sorted.size() - 1.0, std::ceil(fraction * (double) sorted.size()) - 1.0);
+        return sorted[index];
+    }
+
+    template <typename SampleType>
+    BlockStats runConfig(BasicOscillatorAudioProcessor& processor, HeadlessHost::PlayHead& playHead,
+                         const BenchmarkConfig& config, double seconds)
+    {
+        auto& apvts = processor.apvts;
+
+        HeadlessHost::setParameter(apvts, ParamID::Modulation, (float) config.modulation);
+        HeadlessHost::setParameter(apvts, ParamID::InSync, config.inSync ? 1.0f : 0.0f);
+        HeadlessHost::setParameter(apvts, ParamID::OscShape, (float) config.oscShape);
+        HeadlessHost::setParameter(apvts, ParamID::LowPassSlope, (float) config.slope);
+
+        processor.setProcessingPrecision(std::is_same_v<SampleType, double> ? juce::AudioProcessor::doublePrecision
+                                                                            : juce::AudioProcessor::singlePrecision);
+        processor.setPlayConfigDetails(config.numChannels, config.numChannels, config.sampleRate, config.blockSize);
+        processor.prepareToPlay(config.sampleRate, config.blockSize);
+        playHead.prepare(config.sampleRate);
+
+        // One second of input, replayed block by block so input generation isn't timed
+        juce::AudioBuffer<SampleType> input(config.numChannels, (int) config.sampleRate);
+        HeadlessHost::fillNoise(input, 0x05c);
+
+        juce::AudioBuffer<SampleType> buffer(config.numChannels, config.blockSize);
+        juce::MidiBuffer midi;
+
+        auto numBlocks = juce::jmax(1, (int) (seconds * config.sampleRate / config.blockSize));
+        auto numWarmupBlocks = juce::jmax(1, numBlocks / 10);
+
+        std::vector<double> blockTimes;
+        blockTimes.reserve((size_t) numBlocks);
+
+        int readPosition = 0;
+        double totalSeconds = 0.0;
+
+        for (int block = 0; block < numWarmupBlocks + numBlocks; ++block)
+        {
+            for (int channel = 0; channel < config.numChannels; ++channel)
+            {
+                for (int done = 0; done < config.blockSize;)
+                {
+                    auto pos = (readPosition + done) % input.getNumSamples();
+                    auto num = juce::jmin(config.blockSize - done, input.getNumSamples() - pos);
+                    buffer.copyFrom(channel, done, input, channel, pos, num);
+                    done += num;
+                }
+            }
+
+            readPosition = (readPosition + config.blockSize) % input.getNumSamples();
+
+            auto start = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            playHead.advance(config.blockSize);
+
+            if (block >= numWarmupBlocks)
+            {
+                blockTimes.push_back(elapsed * 1.0e6);
+                totalSeconds += elapsed;
+            }
+        }
+
+        processor.releaseResources();
+
+        std::sort(blockTimes.begin(), blockTimes.end());
+
+        BlockStats stats;
+        stats.nsPerSample = totalSeconds * 1.0e9 / ((double) numBlocks * config.blockSize);
+        stats.p50 = percentile(blockTimes, 0.50);
+        stats.p99 = percentile(blockTimes, 0.99);
+        stats.max = blockTimes.back();
+        stats.budgetFraction = stats.p99 * 1.0e-6 / (config.blockSize / config.sampleRate);
+        return stats;
+    }
+
+    juce::String toJson(const BenchmarkConfig& config, bool doublePrecision, const BlockStats& stats)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("precision", doublePrecision ? "double" : "float");
+        object->setProperty("channels", config.numChannels);
+        object->setProperty("block_size", config.blockSize);
+        object->setProperty("sample_rate", config.sampleRate);
+        object->setProperty("modulation", config.modulation);
+        object->setProperty("in_sync", config.inSync);
+        object->setProperty("osc_shape", config.oscShape);
+        object->setProperty("slope", config.slope);
+        object->setProperty("ns_per_sample", stats.nsPerSample);
+        object->setProperty("block_p50_us", stats.p50);
+        object->setProperty("block_p99_us", stats.p99);
+        object->setProperty("block_max_us", stats.max);
+        object->setProperty("p99_budget_fraction", stats.budgetFraction);
+
+        return juce::JSON::toString(juce::var(object), true);
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    auto seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 1.0;
+    auto doublePrecision = args.containsOption("--double");
+    auto numChannels = args.containsOption("--channels")
+                     ? juce::jlimit(1, BasicOscillatorAudioProcessor::maxChannels, args.getValueForOption("--channels").getIntValue())
+                     : 2;
+
+    std::unique_ptr<juce::FileOutputStream> output;
+
+    if (args.containsOption("--output"))
+    {
+        output = args.getFileForOption("--output").createOutputStream();
+
+        if (output == nullptr || ! output->setPosition(0) || ! output->truncate().wasOk())
+        {
+            std::cerr << "Couldn't open output file" << std::endl;
+            return 1;
+        }
+    }
+
+    BasicOscillatorAudioProcessor processor;
+    HeadlessHost::PlayHead playHead;
+    processor.setPlayHead(&playHead);
+
+    const int blockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096 };
+    const double sampleRates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+
+    for (auto sampleRate : sampleRates)
+     for (auto blockSize : blockSizes)
+      for (int modulation = 0; modulation < 2; ++modulation)
+       for (int inSync = 0; inSync < 2; ++inSync)
+        for (int oscShape = 0; oscShape < 4; ++oscShape)
+         for (int slope = 0; slope < 4; ++slope)
+         {
+             // Slope only matters to the filter mode
+             if (modulation == 0 && slope > 0)
+                 continue;
+
+             BenchmarkConfig config { numChannels, blockSize, sampleRate, modulation, inSync != 0, oscShape, slope };
+             auto stats = doublePrecision ? runConfig<double>(processor, playHead, config, seconds)
+                                          : runConfig<float>(processor, playHead, config, seconds);
+             auto line = toJson(config, doublePrecision, stats);
+
+             std::cout << line << std::endl;
+
+             if (output != nullptr)
+                 *output << line << "\n";
+         }
+
+    return 0;
+}
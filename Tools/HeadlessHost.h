@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+    Helpers for driving BasicOscillatorAudioProcessor without a plugin host
+    or editor, shared by the command line tools in this folder.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+namespace HeadlessHost
+{
+    //==============================================================================
+    /** A transport at a fixed tempo, playing unless told otherwise. The caller
+        advances it after every processed block.
+    */
+    class PlayHead : public juce::AudioPlayHead
+    {
+    public:
+        juce::Optional<PositionInfo> getPosition() const override
+        {
+            PositionInfo info;
+            info.setIsPlaying(playing);
+            info.setBpm(bpm);
+            info.setTimeSignature(TimeSignature{});
+            info.setTimeInSamples(samplePosition);
+            info.setTimeInSeconds((double) samplePosition / sampleRate);
+            info.setPpqPosition((double) samplePosition / sampleRate * bpm / 60.0);
+            return info;
+        }
+
+        void prepare(double newSampleRate)
+        {
+            sampleRate = newSampleRate;
+            samplePosition = 0;
+        }
+
+        void advance(int numSamples) { samplePosition += numSamples; }
+
+        double bpm = 120.0;
+        bool playing = true;
+
+    private:
+        double sampleRate = 44100.0;
+        juce::int64 samplePosition = 0;
+    };
+
+    //==============================================================================
+    /** Sets a parameter from its real (denormalised) value, e.g. a choice index. */
+    inline void setParameter(juce::AudioProcessorValueTreeState& apvts, const juce::String& paramID, float value)
+    {
+        if (auto* param = apvts.getParameter(paramID))
+            param->setValueNotifyingHost(param->convertTo0to1(value));
+        else
+            jassertfalse;
+    }
+
+    /** Fills every channel with deterministic white noise at -6 dBFS. */
+    template <typename SampleType>
+    inline void fillNoise(juce::AudioBuffer<SampleType>& buffer, juce::int64 seed)
+    {
+        juce::Random random(seed);
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* data = buffer.getWritePointer(channel);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = (SampleType) (random.nextFloat() - 0.5f);
+        }
+    }
+}
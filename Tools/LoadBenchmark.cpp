@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    Session load benchmark for BasicOscillatorAudioProcessor.
+
+    Build as a JUCE console application from this file plus PluginProcessor.cpp
+    and PluginEditor.cpp, like the benchmark.
+
+    Creates a project's worth of instances and times each phase of loading it:
+    construction, restoring the binary state, restoring the same state again
+    (nothing changes), and restoring the legacy XML state. After each restore
+    every instance's parameters are checked against the saved ones. Prints one
+    JSON object per phase, and exits with 1 if any instance restored
+    differently.
+
+        OscLoadBenchmark [--instances=500]
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include "HeadlessHost.h"
+
+namespace
+{
+    using Instances = std::vector<std::unique_ptr<BasicOscillatorAudioProcessor>>;
+
+    void printPhase(const char* phase, int numInstances, double seconds, size_t stateBytes)
+    {
+        auto* object = new juce::DynamicObject();
+        object->setProperty("phase", phase);
+        object->setProperty("instances", numInstances);
+        object->setProperty("total_ms", seconds * 1.0e3);
+        object->setProperty("per_instance_us", seconds * 1.0e6 / numInstances);
+        object->setProperty("state_bytes", (juce::int64) stateBytes);
+
+        std::cout << juce::JSON::toString(juce::var(object), true) << std::endl;
+    }
+
+    template <typename Fn>
+    double time(Fn&& fn)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+        fn();
+        return juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+    }
+
+    void restoreAll(Instances& instances, const juce::MemoryBlock& state)
+    {
+        for (auto& instance : instances)
+            instance->setStateInformation(state.getData(), (int) state.getSize());
+    }
+
+    // Number of instances whose parameters differ from the reference's
+    int checkRestored(const char* phase, const Instances& instances, const BasicOscillatorAudioProcessor& reference)
+    {
+        int numMismatches = 0;
+
+        auto& expected = reference.getParameters();
+
+        for (auto& instance : instances)
+        {
+            auto& params = instance->getParameters();
+
+            for (int i = 0; i < params.size(); ++i)
+            {
+                if (std::abs(params[i]->getValue() - expected[i]->getValue()) > 1.0e-5f)
+                {
+                    ++numMismatches;
+                    break;
+                }
+            }
+        }
+
+        if (numMismatches > 0)
+            std::cout << "FAIL " << phase << ": " << numMismatches << " of " << instances.size() << " instances restored a different state" << std::endl;
+
+        return numMismatches;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    auto numInstances = args.containsOption("--instances")
+                      ? juce::jmax(1, args.getValueForOption("--instances").getIntValue())
+                      : 500;
+
+    // A session to load, with every parameter away from its default
+    juce::MemoryBlock binaryState, xmlState, defaultState;
+
+    BasicOscillatorAudioProcessor reference;
+    reference.getStateInformation(defaultState);
+
+    juce::Random random(0x05c);
+
+    for (auto* param : reference.getParameters())
+        param->setValueNotifyingHost(random.nextFloat());
+
+    reference.getStateInformation(binaryState);
+
+    if (auto xml = reference.apvts.copyState().createXml())
+        juce::AudioProcessor::copyXmlToBinary(*xml, xmlState);
+
+    Instances instances;
+    instances.reserve((size_t) numInstances);
+
+    printPhase("construct", numInstances, time([&]
+    {
+        for (int i = 0; i < numInstances; ++i)
+            instances.push_back(std::make_unique<BasicOscillatorAudioProcessor>());
+    }), 0);
+
+    int numMismatches = 0;
+
+    printPhase("restore_binary", numInstances, time([&] { restoreAll(instances, binaryState); }), binaryState.getSize());
+    numMismatches += checkRestored("restore_binary", instances, reference);
+
+    printPhase("restore_binary_unchanged", numInstances, time([&] { restoreAll(instances, binaryState); }), binaryState.getSize());
+    numMismatches += checkRestored("restore_binary_unchanged", instances, reference);
+
+    restoreAll(instances, defaultState);
+    printPhase("restore_xml", numInstances, time([&] { restoreAll(instances, xmlState); }), xmlState.getSize());
+    numMismatches += checkRestored("restore_xml", instances, reference);
+
+    return numMismatches > 0 ? 1 : 0;
+}
@@ -0,0 +1,489 @@
+/*
+  ==============================================================================
+
+    Real-time safety check for BasicOscillatorAudioProcessor.
+
+    Build as a JUCE console application from this file plus PluginProcessor.cpp
+    and PluginEditor.cpp, like the benchmark. On Linux also link with -ldl.
+
+    While processBlock runs, every heap allocation or deallocation is counted.
+    On Linux, every call into a blocking pthread lock is counted as well. The
+    tool walks the full product of the test values of every parameter in
+    createParameterLayout apart from the modulation ones (route depths, LFO 2
+    and 3, Phase Offset), which are held at their defaults. Those would make
+    the product far too large, so they are covered by a seeded random sample
+    of combinations in which every parameter takes one of its test values.
+    Test values are every value of a discrete parameter, and min/default/max
+    of a continuous one. It changes parameters between blocks without
+    re-preparing, so the change-handling paths run under the check too.
+    Telemetry for the editor's scopes is switched on, as if an editor were
+    open, and drained between blocks.
+
+    After the walk, the blocks following each of these are checked as well:
+    every factory program swapped in by a MIDI program change and by
+    setCurrentProgram(), note and controller MIDI, restoring a saved session
+    and the defaults with setStateInformation(), and the transport stopping
+    and starting. Exits with 1 if any block allocated, freed or locked.
+
+    What a pass shows is limited to that: none of the blocks above allocated,
+    freed or entered a blocking lock on the calling thread. Host calls are
+    made between blocks rather than concurrently with them. Elsewhere than
+    Linux, locks and the C allocator go unseen. It is evidence for the paths
+    it drives, not a proof that the audio path is wait-free.
+
+    Everything runs once through the float processBlock and once through the
+    double one, which has its own signal path. --channels sets the bus width,
+    so wide layouts can be checked too.
+
+        OscRealtimeCheck [--blocks-per-combination=4] [--random-combinations=2000] [--channels=2]
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include "HeadlessHost.h"
+
+#if JUCE_LINUX
+ #include <cerrno>
+ #include <dlfcn.h>
+ #include <pthread.h>
+#endif
+
+namespace RealtimeCheck
+{
+    // Only set on the thread calling processBlock, and only while it does
+    thread_local bool insideAudioCallback = false;
+
+    std::atomic<int> allocations { 0 };
+    std::atomic<int> deallocations { 0 };
+    std::atomic<int> locks { 0 };
+
+    inline void note(std::atomic<int>& counter) noexcept
+    {
+        if (insideAudioCallback)
+            counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    struct ScopedAudioCallback
+    {
+        ScopedAudioCallback()  { insideAudioCallback = true; }
+        ~ScopedAudioCallback() { insideAudioCallback = false; }
+    };
+
+    int getViolations() noexcept
+    {
+        return allocations.load() + deallocations.load() + locks.load();
+    }
+
+    void clear() noexcept
+    {
+        allocations = 0;
+        deallocations = 0;
+        locks = 0;
+    }
+}
+
+//==============================================================================
+#if JUCE_LINUX
+
+// Interposing the C allocator also catches operator new, juce::HeapBlock and
+// anything else in the process that ends up in malloc.
+extern "C"
+{
+    void* __libc_malloc(size_t);
+    void* __libc_calloc(size_t, size_t);
+    void* __libc_realloc(void*, size_t);
+    void* __libc_memalign(size_t, size_t);
+    void  __libc_free(void*);
+
+    void* malloc(size_t size)                 { RealtimeCheck::note(RealtimeCheck::allocations); return __libc_malloc(size); }
+    void* calloc(size_t num, size_t size)     { RealtimeCheck::note(RealtimeCheck::allocations); return __libc_calloc(num, size); }
+    void* realloc(void* ptr, size_t size)     { RealtimeCheck::note(RealtimeCheck::allocations); return __libc_realloc(ptr, size); }
+    void* memalign(size_t align, size_t size) { RealtimeCheck::note(RealtimeCheck::allocations); return __libc_memalign(align, size); }
+    void* aligned_alloc(size_t align, size_t size) { return memalign(align, size); }
+
+    int posix_memalign(void** result, size_t align, size_t size)
+    {
+        *result = memalign(align, size);
+        return *result != nullptr ? 0 : ENOMEM;
+    }
+
+    void free(void* ptr)
+    {
+        if (ptr != nullptr)
+            RealtimeCheck::note(RealtimeCheck::deallocations);
+
+        __libc_free(ptr);
+    }
+
+    // The real lock functions are looked up lazily; dlsym doesn't go through
+    // these hooks, and the pointers are constant-initialised so no static
+    // initialisation guard (which could lock) is involved.
+    using MutexFn = int (*)(pthread_mutex_t*);
+    using RwLockFn = int (*)(pthread_rwlock_t*);
+    using CondWaitFn = int (*)(pthread_cond_t*, pthread_mutex_t*);
+
+    static std::atomic<MutexFn> realMutexLock { nullptr };
+    static std::atomic<RwLockFn> realRdLock { nullptr };
+    static std::atomic<RwLockFn> realWrLock { nullptr };
+    static std::atomic<CondWaitFn> realCondWait { nullptr };
+
+    template <typename Fn>
+    static Fn resolve(std::atomic<Fn>& fn, const char* name)
+    {
+        auto real = fn.load(std::memory_order_relaxed);
+
+        if (real == nullptr)
+        {
+            real = reinterpret_cast<Fn>(dlsym(RTLD_NEXT, name));
+            fn.store(real, std::memory_order_relaxed);
+        }
+
+        return real;
+    }
+
+    int pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        RealtimeCheck::note(RealtimeCheck::locks);
+        return resolve(realMutexLock, "pthread_mutex_lock")(mutex);
+    }
+
+    int pthread_rwlock_rdlock(pthread_rwlock_t* lock)
+    {
+        RealtimeCheck::note(RealtimeCheck::locks);
+        return resolve(realRdLock, "pthread_rwlock_rdlock")(lock);
+    }
+
+    int pthread_rwlock_wrlock(pthread_rwlock_t* lock)
+    {
+        RealtimeCheck::note(RealtimeCheck::locks);
+        return resolve(realWrLock, "pthread_rwlock_wrlock")(lock);
+    }
+
+    int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+    {
+        RealtimeCheck::note(RealtimeCheck::locks);
+        return resolve(realCondWait, "pthread_cond_wait")(cond, mutex);
+    }
+}
+
+#else
+
+// Elsewhere only the C++ allocator is hooked
+void* operator new(size_t size)
+{
+    RealtimeCheck::note(RealtimeCheck::allocations);
+
+    if (auto* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)                               { return operator new(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept   { RealtimeCheck::note(RealtimeCheck::allocations); return std::malloc(size == 0 ? 1 : size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { RealtimeCheck::note(RealtimeCheck::allocations); return std::malloc(size == 0 ? 1 : size); }
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+        RealtimeCheck::note(RealtimeCheck::deallocations);
+
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept                 { operator delete(ptr); }
+void operator delete(void* ptr, size_t) noexcept           { operator delete(ptr); }
+void operator delete[](void* ptr, size_t) noexcept         { operator delete(ptr); }
+
+#endif
+
+//==============================================================================
+namespace
+{
+    /** Normalised values tried for one parameter. */
+    std::vector<float> getTestValues(juce::AudioProcessorParameter& param)
+    {
+        std::vector<float> values;
+
+        if (param.isDiscrete() || param.isBoolean())
+        {
+            auto numSteps = param.isBoolean() ? 2 : juce::jmax(2, param.getNumSteps());
+
+            for (int step = 0; step < numSteps; ++step)
+                values.push_back((float) step / (float) (numSteps - 1));
+        }
+        else
+        {
+            values = { 0.0f, param.getDefaultValue(), 1.0f };
+        }
+
+        return values;
+    }
+
+    /** The IDs left out of the full product: every matrix route, LFO 2 and 3, and Phase Offset. */
+    juce::StringArray getModulationParameterIDs()
+    {
+        juce::StringArray ids;
+
+        for (int source = 0; source < NumModSources; ++source)
+            for (int destination = 0; destination < NumModDestinations; ++destination)
+                ids.add(ParamID::route(source, destination));
+
+        for (int i = 0; i < numExtraLfos; ++i)
+        {
+            ids.add(ParamID::ExtraLfoRate[i]);
+            ids.add(ParamID::ExtraLfoShape[i]);
+        }
+
+        ids.add(ParamID::PhaseOffset);
+        return ids;
+    }
+
+    juce::String describe(const juce::Array<juce::AudioProcessorParameter*>& params)
+    {
+        juce::StringArray parts;
+
+        for (auto* param : params)
+            parts.add(param->getName(64) + "=" + param->getCurrentValueAsText());
+
+        return parts.joinIntoString(", ");
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    auto blocksPerCombination = args.containsOption("--blocks-per-combination")
+                              ? juce::jmax(1, args.getValueForOption("--blocks-per-combination").getIntValue())
+                              : 4;
+
+    auto numChannels = args.containsOption("--channels")
+                     ? juce::jlimit(1, BasicOscillatorAudioProcessor::maxChannels, args.getValueForOption("--channels").getIntValue())
+                     : 2;
+
+    auto numRandomCombinations = args.containsOption("--random-combinations")
+                               ? juce::jmax(0, args.getValueForOption("--random-combinations").getIntValue())
+                               : 2000;
+
+    BasicOscillatorAudioProcessor processor;
+    HeadlessHost::PlayHead playHead;
+    processor.setPlayHead(&playHead);
+    processor.getTelemetry().setEnabled(true);
+
+    auto& params = processor.getParameters();
+
+    std::vector<std::vector<float>> testValues;
+
+    for (auto* param : params)
+        testValues.push_back(getTestValues(*param));
+
+    auto modulationIDs = getModulationParameterIDs();
+    std::vector<bool> inProduct;
+
+    for (auto* param : params)
+    {
+        auto* withID = dynamic_cast<juce::AudioProcessorParameterWithID*>(param);
+        inProduct.push_back(withID == nullptr || ! modulationIDs.contains(withID->paramID));
+    }
+
+    // A session to restore between blocks, and the defaults to go back to
+    juce::MemoryBlock defaultState, sessionState;
+    processor.getStateInformation(defaultState);
+
+    {
+        juce::Random random(0x05c);
+
+        for (auto* param : params)
+            param->setValueNotifyingHost(random.nextFloat());
+
+        processor.getStateInformation(sessionState);
+        processor.setStateInformation(defaultState.getData(), (int) defaultState.getSize());
+    }
+
+    const double sampleRates[] = { 44100.0, 96000.0 };
+    const int blockSizes[] = { 32, 100, 512 };
+
+    int numBlocks = 0;
+    int numFailures = 0;
+
+    // Both processBlock overloads, each with its own signal path
+    const juce::AudioProcessor::ProcessingPrecision precisions[] = { juce::AudioProcessor::singlePrecision,
+                                                                     juce::AudioProcessor::doublePrecision };
+
+    for (auto precision : precisions)
+    {
+        for (auto sampleRate : sampleRates)
+        {
+            for (auto blockSize : blockSizes)
+            {
+                processor.setProcessingPrecision(precision);
+                processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+                processor.prepareToPlay(sampleRate, blockSize);
+                playHead.prepare(sampleRate);
+
+                auto isDouble = precision == juce::AudioProcessor::doublePrecision;
+                juce::AudioBuffer<float> buffer(numChannels, blockSize);
+                juce::AudioBuffer<double> doubleBuffer(numChannels, blockSize);
+                juce::MidiBuffer midi;
+
+                std::vector<float> values((size_t) params.size());
+
+                // One block under the check; false if it allocated, freed or locked
+                auto runBlock = [&]
+                {
+                    if (isDouble)
+                        HeadlessHost::fillNoise(doubleBuffer, numBlocks);
+                    else
+                        HeadlessHost::fillNoise(buffer, numBlocks);
+
+                    RealtimeCheck::clear();
+
+                    {
+                        RealtimeCheck::ScopedAudioCallback audioCallback;
+
+                        if (isDouble)
+                            processor.processBlock(doubleBuffer, midi);
+                        else
+                            processor.processBlock(buffer, midi);
+                    }
+
+                    playHead.advance(blockSize);
+                    ++numBlocks;
+
+                    for (Telemetry::Frame frame; processor.getTelemetry().pop(frame);)
+                        ;
+
+                    return RealtimeCheck::getViolations() == 0;
+                };
+
+                auto reportFailure = [&](const juce::String& context)
+                {
+                    if (++numFailures <= 20)
+                        std::cout << "FAIL " << (isDouble ? "double, " : "float, ") << sampleRate << " Hz, " << blockSize << " samples: "
+                                  << RealtimeCheck::allocations.load() << " allocations, "
+                                  << RealtimeCheck::deallocations.load() << " deallocations, "
+                                  << RealtimeCheck::locks.load() << " locks with "
+                                  << context << std::endl;
+                };
+
+                auto runCombination = [&]
+                {
+                    for (int i = 0; i < params.size(); ++i)
+                        if (params[i]->getValue() != values[(size_t) i])
+                            params[i]->setValueNotifyingHost(values[(size_t) i]);
+
+                    for (int block = 0; block < blocksPerCombination; ++block)
+                    {
+                        if (! runBlock())
+                        {
+                            reportFailure(describe(params));
+                            break;
+                        }
+                    }
+                };
+
+                // Mixed-radix counter over the test values of every parameter in
+                // the product, with the modulation parameters at their defaults
+                std::vector<size_t> combination((size_t) params.size(), 0);
+
+                for (bool done = false; ! done;)
+                {
+                    for (size_t i = 0; i < values.size(); ++i)
+                        values[i] = inProduct[i] ? testValues[i][combination[i]] : params[(int) i]->getDefaultValue();
+
+                    runCombination();
+
+                    done = true;
+
+                    for (size_t i = 0; i < combination.size(); ++i)
+                    {
+                        if (! inProduct[i])
+                            continue;
+
+                        if (++combination[i] < testValues[i].size())
+                        {
+                            done = false;
+                            break;
+                        }
+
+                        combination[i] = 0;
+                    }
+                }
+
+                // Every parameter at once, so the matrix meets the rest of the
+                // layout in all sorts of settings. Seeded, so failures reproduce.
+                juce::Random random(0x05c);
+
+                for (int n = 0; n < numRandomCombinations; ++n)
+                {
+                    for (size_t i = 0; i < values.size(); ++i)
+                        values[i] = testValues[i][(size_t) random.nextInt((int) testValues[i].size())];
+
+                    runCombination();
+                }
+
+                // Blocks following a change made by the host, or carried by the
+                // first block's MidiBuffer
+                auto runAfterChange = [&](const juce::String& context)
+                {
+                    for (int block = 0; block < blocksPerCombination; ++block)
+                    {
+                        auto clean = runBlock();
+                        midi.clear();
+
+                        if (! clean)
+                        {
+                            reportFailure(context + ", block " + juce::String(block) + " after it");
+                            break;
+                        }
+                    }
+                };
+
+                // Program swaps, which must take the prepared filter state rather
+                // than design or allocate anything. A MIDI program change is
+                // applied by the audio thread within the block that carries it;
+                // setCurrentProgram() is called by the host between blocks and
+                // swapped in at the next one. Each is followed by the blocks in
+                // which the parameters catch up with the program.
+                for (int program = 0; program < processor.getNumPrograms(); ++program)
+                {
+                    midi.addEvent(juce::MidiMessage::programChange(1, program), 0);
+                    runAfterChange("MIDI program change to " + juce::String(program));
+
+                    auto next = (program + 1) % processor.getNumPrograms();
+                    processor.setCurrentProgram(next);
+                    runAfterChange("setCurrentProgram(" + juce::String(next) + ")");
+                }
+
+                // MIDI the processor has no use for must pass through untouched
+                midi.addEvent(juce::MidiMessage::noteOn(1, 60, (juce::uint8) 100), 0);
+                midi.addEvent(juce::MidiMessage::controllerEvent(1, 1, 64), blockSize / 2);
+                midi.addEvent(juce::MidiMessage::noteOff(1, 60), blockSize - 1);
+                runAfterChange("note and controller MIDI");
+
+                // The host reloading a session, then the defaults, while playing
+                processor.setStateInformation(sessionState.getData(), (int) sessionState.getSize());
+                runAfterChange("session state restored");
+
+                processor.setStateInformation(defaultState.getData(), (int) defaultState.getSize());
+                runAfterChange("default state restored");
+
+                // The transport stopping and starting again, which re-anchors the synced LFO
+                playHead.playing = false;
+                runAfterChange("transport stopped");
+
+                playHead.playing = true;
+                runAfterChange("transport restarted");
+
+                processor.releaseResources();
+            }
+        }
+    }
+
+    std::cout << numBlocks << " blocks checked, " << numFailures << " failed" << std::endl;
+    return numFailures > 0 ? 1 : 0;
+}
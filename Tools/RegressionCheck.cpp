@@ -0,0 +1,261 @@
+/*
+  ==============================================================================
+
+    Golden-output regression check for BasicOscillatorAudioProcessor.
+
+    Build as a JUCE console application from this file plus PluginProcessor.cpp
+    and PluginEditor.cpp, like the benchmark.
+
+    Renders fixed input signals (seeded noise and DC) through a freshly
+    prepared processor for every combination of OscShape, NoteVal, Feel,
+    Modulation, InSync and LowPass Slope. Each combination is rendered at
+    several block sizes and as one block covering the whole render, with the
+    transport playing, and every render is hashed (FNV-1a over the sample
+    bits).
+
+        --record=golden.json   writes the hashes, to check in as the reference
+        --verify=golden.json   fails on any hash that differs from the reference
+
+    Hashes are only comparable between builds of the same code generation:
+    another compiler, architecture or SIMD width may legitimately round
+    differently, so each platform keeps its own reference file. Record a new
+    one whenever the sound is meant to change. Tools/regression_check.sh
+    verifies against the checked-in Tools/Golden/<os>-<arch>.json, fails when
+    there is none, and only records it when given --record.
+
+    Independently of any reference, every combination must also render the
+    same at every block size as in one block, within blockTolerance, or
+    syncedBlockTolerance for synced combinations, whose LFO is re-anchored to
+    the song position at the start of each block. Exits with 1 on any
+    failure.
+
+        OscRegressionCheck [--record=<file> | --verify=<file>] [--seconds=1.0]
+
+  ==============================================================================
+*/
+
+#include <iostream>
+#include "HeadlessHost.h"
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numChannels = 2;
+
+    // Multiples of SvfLowPass::controlInterval, so the swept filter reads its
+    // cutoff at the same samples whatever the block size
+    const int blockSizes[] = { 64, 480, 4096 };
+
+    // Allows for the vectorised and scalar tails of FloatVectorOperations
+    // rounding differently; anything audible is far above this
+    constexpr float blockTolerance = 1.0e-6f;
+
+    // The per-block anchor can round the LFO phase differently from one long
+    // block, which the modulated filter carries into the output
+    constexpr float syncedBlockTolerance = 1.0e-4f;
+
+    struct Combination
+    {
+        int oscShape;
+        int noteVal;
+        int feel;
+        int modulation;
+        bool inSync;
+        int slope;
+
+        juce::String getKey() const
+        {
+            return "OscShape=" + juce::String(oscShape) + " NoteVal=" + juce::String(noteVal) + " Feel=" + juce::String(feel)
+                 + " Modulation=" + juce::String(modulation) + " InSync=" + juce::String((int) inSync) + " Slope=" + juce::String(slope);
+        }
+    };
+
+    struct Input
+    {
+        const char* name;
+        juce::AudioBuffer<float> buffer;
+    };
+
+    std::vector<Input> makeInputs(int numSamples)
+    {
+        std::vector<Input> inputs;
+
+        inputs.push_back({ "noise", juce::AudioBuffer<float>(numChannels, numSamples) });
+        HeadlessHost::fillNoise(inputs.back().buffer, 0x05c);
+
+        // Shows the tremolo and gain curves on their own
+        inputs.push_back({ "dc", juce::AudioBuffer<float>(numChannels, numSamples) });
+
+        for (int channel = 0; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::fill(inputs.back().buffer.getWritePointer(channel), 0.5f, numSamples);
+
+        return inputs;
+    }
+
+    juce::AudioBuffer<float> render(const Combination& combination, const juce::AudioBuffer<float>& input, int blockSize)
+    {
+        BasicOscillatorAudioProcessor processor;
+        HeadlessHost::PlayHead playHead;
+        processor.setPlayHead(&playHead);
+
+        auto& apvts = processor.apvts;
+
+        HeadlessHost::setParameter(apvts, ParamID::OscShape, (float) combination.oscShape);
+        HeadlessHost::setParameter(apvts, ParamID::NoteVal, (float) combination.noteVal);
+        HeadlessHost::setParameter(apvts, ParamID::Feel, (float) combination.feel);
+        HeadlessHost::setParameter(apvts, ParamID::Modulation, (float) combination.modulation);
+        HeadlessHost::setParameter(apvts, ParamID::InSync, combination.inSync ? 1.0f : 0.0f);
+        HeadlessHost::setParameter(apvts, ParamID::LowPassSlope, (float) combination.slope);
+
+        processor.setPlayConfigDetails(numChannels, numChannels, sampleRate, blockSize);
+        processor.prepareToPlay(sampleRate, blockSize);
+        playHead.prepare(sampleRate);
+
+        juce::AudioBuffer<float> output(input);
+        juce::MidiBuffer midi;
+
+        for (int start = 0; start < output.getNumSamples(); start += blockSize)
+        {
+            auto numSamples = juce::jmin(blockSize, output.getNumSamples() - start);
+            juce::AudioBuffer<float> block(output.getArrayOfWritePointers(), numChannels, start, numSamples);
+
+            processor.processBlock(block, midi);
+            playHead.advance(numSamples);
+        }
+
+        processor.releaseResources();
+        return output;
+    }
+
+    juce::String hash(const juce::AudioBuffer<float>& buffer)
+    {
+        juce::uint64 state = 0xcbf29ce484222325ull;
+
+        for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        {
+            auto* bytes = reinterpret_cast<const juce::uint8*>(buffer.getReadPointer(channel));
+
+            for (size_t i = 0; i < sizeof(float) * (size_t) buffer.getNumSamples(); ++i)
+                state = (state ^ bytes[i]) * 0x100000001b3ull;
+        }
+
+        return juce::String::toHexString((juce::int64) state).paddedLeft('0', 16);
+    }
+
+    float getMaxDifference(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+    {
+        float maxDifference = 0.0f;
+
+        for (int channel = 0; channel < a.getNumChannels(); ++channel)
+            for (int i = 0; i < a.getNumSamples(); ++i)
+                maxDifference = juce::jmax(maxDifference, std::abs(a.getSample(channel, i) - b.getSample(channel, i)));
+
+        return maxDifference;
+    }
+
+    void fail(int& numFailures, const juce::String& message)
+    {
+        if (++numFailures <= 20)
+            std::cout << "FAIL " << message << std::endl;
+    }
+}
+
+//==============================================================================
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+    juce::ArgumentList args(argc, argv);
+
+    auto seconds = args.containsOption("--seconds") ? juce::jmax(0.01, args.getValueForOption("--seconds").getDoubleValue()) : 1.0;
+    auto numSamples = (int) (seconds * sampleRate);
+
+    auto recordFile = args.containsOption("--record") ? args.getFileForOption("--record") : juce::File();
+    auto verifyFile = args.containsOption("--verify") ? args.getFileForOption("--verify") : juce::File();
+
+    juce::DynamicObject::Ptr reference;
+
+    if (verifyFile != juce::File())
+    {
+        reference = juce::JSON::parse(verifyFile).getDynamicObject();
+
+        if (reference == nullptr)
+        {
+            std::cerr << "Couldn't read reference hashes from " << verifyFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    auto inputs = makeInputs(numSamples);
+
+    juce::DynamicObject::Ptr hashes = new juce::DynamicObject();
+    int numRenders = 0;
+    int numFailures = 0;
+
+    std::vector<Combination> combinations;
+
+    for (int oscShape = 0; oscShape < 4; ++oscShape)
+     for (int noteVal = 0; noteVal < 7; ++noteVal)
+      for (int feel = 0; feel < 3; ++feel)
+       for (int modulation = 0; modulation < 2; ++modulation)
+        for (int inSync = 0; inSync < 2; ++inSync)
+         for (int slope = 0; slope < 4; ++slope)
+             combinations.push_back({ oscShape, noteVal, feel, modulation, inSync != 0, slope });
+
+    for (auto& combination : combinations)
+    {
+        for (auto& input : inputs)
+        {
+            auto key = combination.getKey() + " Input=" + input.name;
+
+            auto check = [&](const juce::String& renderKey, const juce::AudioBuffer<float>& output)
+            {
+                auto value = hash(output);
+                hashes->setProperty(renderKey, value);
+                ++numRenders;
+
+                if (reference != nullptr)
+                {
+                    if (! reference->hasProperty(renderKey))
+                        fail(numFailures, renderKey + ": no reference hash");
+                    else if (reference->getProperty(renderKey).toString() != value)
+                        fail(numFailures, renderKey + ": hash " + value + ", reference " + reference->getProperty(renderKey).toString());
+                }
+            };
+
+            auto whole = render(combination, input.buffer, numSamples);
+            check(key + " Block=whole", whole);
+
+            std::vector<juce::AudioBuffer<float>> blocked;
+
+            for (auto blockSize : blockSizes)
+            {
+                blocked.push_back(render(combination, input.buffer, blockSize));
+                check(key + " Block=" + juce::String(blockSize), blocked.back());
+            }
+
+            auto tolerance = combination.inSync ? syncedBlockTolerance : blockTolerance;
+
+            for (size_t i = 0; i < blocked.size(); ++i)
+            {
+                auto difference = getMaxDifference(whole, blocked[i]);
+
+                if (difference > tolerance)
+                    fail(numFailures, key + ": " + juce::String(blockSizes[i]) + "-sample blocks differ from one block by " + juce::String(difference));
+            }
+        }
+    }
+
+    if (recordFile != juce::File())
+    {
+        if (! recordFile.replaceWithText(juce::JSON::toString(juce::var(hashes.get()))))
+        {
+            std::cerr << "Couldn't write " << recordFile.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        std::cout << "Recorded " << numRenders << " hashes to " << recordFile.getFullPathName() << std::endl;
+    }
+
+    std::cout << numRenders << " renders checked, " << numFailures << " failed" << std::endl;
+    return numFailures > 0 ? 1 : 0;
+}
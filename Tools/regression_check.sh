@@ -0,0 +1,47 @@
+#!/bin/sh
+#
+# Runs OscRegressionCheck against the golden hashes for this platform, for
+# CI or before a commit. The references live in Tools/Golden/<os>-<arch>.json
+# and are checked in with the suite; a platform without one fails.
+#
+#     Tools/regression_check.sh <path to OscRegressionCheck> [--seconds=1.0]
+#     Tools/regression_check.sh --record <path to OscRegressionCheck> [--seconds=1.0]
+#
+# --record writes this platform's reference instead of verifying it. Only use
+# it for a new platform or when the sound is meant to change, and check the
+# file in with that change.
+
+set -e
+
+record=0
+
+if [ "$1" = "--record" ]; then
+    record=1
+    shift
+fi
+
+if [ $# -lt 1 ] || [ ! -x "$1" ]; then
+    echo "usage: $0 [--record] <path to OscRegressionCheck> [options]" >&2
+    exit 2
+fi
+
+check="$1"
+shift
+
+golden="$(dirname "$0")/Golden"
+reference="$golden/$(uname -s | tr '[:upper:]' '[:lower:]')-$(uname -m).json"
+
+if [ $record -eq 1 ]; then
+    mkdir -p "$golden"
+    "$check" --record="$reference" "$@"
+    echo "Recorded $reference, check it in"
+    exit 0
+fi
+
+if [ ! -f "$reference" ]; then
+    echo "No reference for this platform: $reference" >&2
+    echo "Record one with $0 --record $check and check it in" >&2
+    exit 1
+fi
+
+exec "$check" --verify="$reference" "$@"
@@ -0,0 +1,50 @@
+#ifndef TripleBuffer_hpp
+#define TripleBuffer_hpp
+
+//==============================================================================
+// Lock-free single-writer/single-reader triple buffer. The writer fills
+// getWriteBuffer() and calls publish(); the reader calls pull() and, if it
+// returns true, reads the newest value from getReadBuffer(). Neither side ever
+// blocks or allocates, and the reader always sees a complete value.
+
+template <typename ValueType>
+class TripleBuffer
+{
+public:
+	TripleBuffer() = default;
+
+	//==============================================================================
+	ValueType& getWriteBuffer() noexcept { return buffers[(size_t) writeIndex]; }
+
+	void publish() noexcept
+	{
+		auto previous = middle.exchange (writeIndex | newDataFlag, std::memory_order_acq_rel);
+		writeIndex = previous & indexMask;
+	}
+
+	//==============================================================================
+	bool pull() noexcept
+	{
+		if ((middle.load (std::memory_order_relaxed) & newDataFlag) == 0)
+			return false;
+
+		auto previous = middle.exchange (readIndex, std::memory_order_acq_rel);
+		readIndex = previous & indexMask;
+		return true;
+	}
+
+	const ValueType& getReadBuffer() const noexcept { return buffers[(size_t) readIndex]; }
+
+private:
+	static constexpr int indexMask = 3;
+	static constexpr int newDataFlag = 4;
+
+	std::array<ValueType, 3> buffers {};
+	int writeIndex = 0;
+	int readIndex = 1;
+	std::atomic<int> middle { 2 };
+
+	JUCE_DECLARE_NON_COPYABLE (TripleBuffer)
+};
+
+#endif // TripleBuffer.hpp